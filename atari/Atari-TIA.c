@@ -6,6 +6,7 @@
  * Implements the TIA memory map.
  */
 
+#include <string.h>
 #include "Atari-TIA.h"
 #include "external/ili9341.h"
 #include "external/platform_util.h"
@@ -13,17 +14,122 @@
 atari_tia tia;
 
 tia_pixel_t tia_line_buffer[];
+
+#ifdef DEFERRED_RENDERER
+/* Rather than generating each pixel as its colour clock passes, the line is
+ * rendered in one pass once it completes, or before the line buffer is
+ * drawn or cleared part way through. Writes made during the visible part of
+ * the line are logged with the colour clock they happened on. Rendering
+ * starts from a copy of the TIA's state taken before the first of them and
+ * replays each in turn, generating the span of pixels between writes from
+ * the state at the time, so mid-line changes land on the exact pixel.
+ */
+#define TIA_WRITE_LOG_LENGTH 32
+
+typedef struct {
+    uint8_t colour_clock;
+    uint8_t reg;
+    uint8_t value;
+} tia_write_t;
+
+static tia_write_t tia_write_log[TIA_WRITE_LOG_LENGTH];
+static int tia_write_log_length = 0;
+static atari_tia tia_line_state;    /* State as of tia_render_clock if writes are logged */
+static int tia_render_clock = TIA_COLOUR_CLOCK_TOTAL; /* First colour clock not yet rendered */
+
+static void TIA_log_write(uint8_t reg, uint8_t value);
+static void TIA_render_pending(void);
+#endif /* DEFERRED_RENDERER */
+
+#ifdef SCANLINE_CACHE
+#ifndef DEFERRED_RENDERER
+    #error "SCANLINE_CACHE requires DEFERRED_RENDERER"
+#endif
+/* Many screens repeat identical lines: blank lines, static bands of
+ * playfield, rows of a sprite drawn over and over. Whole lines rendered
+ * without any writes during them are kept along with the state they were
+ * rendered from, and any later span drawn from the same state is copied
+ * out of the cache rather than generated again.
+ */
+typedef struct {
+    tia_line_mask_t line_masks[5];  /* P0, P1, M0, M1, PF */
+    uint8_t colours[4];             /* COLUP0, COLUP1, COLUPF, COLUBK */
+    uint8_t control;                /* CTRLPF score and priority bits */
+} tia_scanline_key_t;
+
+typedef struct {
+    tia_scanline_key_t key;
+    uint8_t valid;
+    uint16_t collisions;            /* Latched over the line, from tia_collision_map */
+    tia_pixel_t pixels[TIA_COLOUR_CLOCK_VISIBLE];
+} tia_scanline_t;
+
+static tia_scanline_t tia_scanline_cache[TIA_SCANLINE_CACHE_ENTRIES];
+static uint32_t tia_scanline_cache_hits = 0;
+static uint32_t tia_scanline_cache_misses = 0;
+
+static void TIA_render_cached(int clocks);
+#endif /* SCANLINE_CACHE */
+
 /* See page 40 of docs/Stella Programmer's Guide.pdf */
-uint8_t tia_player_size_map[] = {
-    0x80, /* 0: One copy */
-    0xA0, /* 1: Two copies - close */
-    0x90, /* 2: Two copies - medium */
-    0xA8, /* 3: Three copies - close */
-    0x81, /* 4: Two copies - wide */
-    0xC0, /* 5: Double size player */
-    0x89, /* 6: Three copies medium */
-    0xF0  /* 7: Quad-sized player */
+const tia_player_size_t tia_player_sizes[] = {
+    { 1, { 8 },         1 }, /* 0: One copy */
+    { 2, { 8, 24 },     1 }, /* 1: Two copies - close */
+    { 2, { 8, 40 },     1 }, /* 2: Two copies - medium */
+    { 3, { 8, 24, 40 }, 1 }, /* 3: Three copies - close */
+    { 2, { 8, 72 },     1 }, /* 4: Two copies - wide */
+    { 1, { 8 },         2 }, /* 5: Double size player */
+    { 3, { 8, 40, 72 }, 1 }, /* 6: Three copies medium */
+    { 1, { 8 },         4 }  /* 7: Quad-sized player */
+};
+
+/* Playfield registers expanded to a mask of their 4-clock cells, bit 0 of
+ * the register giving the first cell. Built at compile time so as to sit
+ * in flash.
+ */
+#define PF_CELLS(b) ( \
+    (((b) & 0x01) ? 0x0000000F : 0) | (((b) & 0x02) ? 0x000000F0 : 0) | \
+    (((b) & 0x04) ? 0x00000F00 : 0) | (((b) & 0x08) ? 0x0000F000 : 0) | \
+    (((b) & 0x10) ? 0x000F0000 : 0) | (((b) & 0x20) ? 0x00F00000 : 0) | \
+    (((b) & 0x40) ? 0x0F000000 : 0) | (((b) & 0x80) ? 0xF0000000 : 0))
+/* As above, reflected: bit 7 of the register giving the first cell */
+#define PF_CELLS_REFLECTED(b) ( \
+    (((b) & 0x80) ? 0x0000000F : 0) | (((b) & 0x40) ? 0x000000F0 : 0) | \
+    (((b) & 0x20) ? 0x00000F00 : 0) | (((b) & 0x10) ? 0x0000F000 : 0) | \
+    (((b) & 0x08) ? 0x000F0000 : 0) | (((b) & 0x04) ? 0x00F00000 : 0) | \
+    (((b) & 0x02) ? 0x0F000000 : 0) | (((b) & 0x01) ? 0xF0000000 : 0))
+#define TABLE_ROW4(f, n)   f(n), f((n)+1), f((n)+2), f((n)+3)
+#define TABLE_ROW16(f, n)  TABLE_ROW4(f, n), TABLE_ROW4(f, (n)+4), TABLE_ROW4(f, (n)+8), TABLE_ROW4(f, (n)+12)
+#define TABLE_ROW64(f, n)  TABLE_ROW16(f, n), TABLE_ROW16(f, (n)+16), TABLE_ROW16(f, (n)+32), TABLE_ROW16(f, (n)+48)
+#define TABLE_256(f)     TABLE_ROW64(f, 0), TABLE_ROW64(f, 64), TABLE_ROW64(f, 128), TABLE_ROW64(f, 192)
+
+static const uint32_t tia_playfield_cells[256] = { TABLE_256(PF_CELLS) };
+static const uint32_t tia_playfield_cells_reflected[256] = { TABLE_256(PF_CELLS_REFLECTED) };
+
+/* Player graphics as pixels of the line mask, bit 0 leftmost, indexed by
+ * whether REFPx reflects them and the GRPx byte.
+ */
+#define GRP_PIXELS(b) (b)
+#define GRP_PIXELS_REFLECTED(b) ( \
+    (((b) & 0x01) << 7) | (((b) & 0x02) << 5) | (((b) & 0x04) << 3) | (((b) & 0x08) << 1) | \
+    (((b) & 0x10) >> 1) | (((b) & 0x20) >> 3) | (((b) & 0x40) >> 5) | (((b) & 0x80) >> 7))
+/* Player pixels stretched to two clocks each for double size players. Quad
+ * size players take four clocks per pixel, just as the playfield's cells.
+ */
+#define GRP_PIXELS_DOUBLE(b) ( \
+    (((b) & 0x01) ? 0x0003 : 0) | (((b) & 0x02) ? 0x000C : 0) | \
+    (((b) & 0x04) ? 0x0030 : 0) | (((b) & 0x08) ? 0x00C0 : 0) | \
+    (((b) & 0x10) ? 0x0300 : 0) | (((b) & 0x20) ? 0x0C00 : 0) | \
+    (((b) & 0x40) ? 0x3000 : 0) | (((b) & 0x80) ? 0xC000 : 0))
+
+static const uint8_t tia_player_pixels[2][256] = {
+    { TABLE_256(GRP_PIXELS) },
+    { TABLE_256(GRP_PIXELS_REFLECTED) }
 };
+static const uint16_t tia_player_pixels_double[256] = { TABLE_256(GRP_PIXELS_DOUBLE) };
+
+uint16_t tia_collision_map[TIA_OBJECT_CODES];
+uint8_t tia_priority_map[TIA_PLAYFIELD_MODES][TIA_OBJECT_CODES * 2];
 
 /* Usage note:
  *
@@ -331,11 +437,77 @@ tia_pixel_t tia_test_line[] = {
 };
 #endif /* COLOUR_TEST */
 
+/* Adds a collision to the map for every combination of objects which
+ * includes both of a pair.
+ *
+ * objects: the pair of objects colliding
+ * reg: collision register latching it
+ * bit: D7 (0x80) or D6 (0x40) of the register
+ */
+static void TIA_add_collision(uint8_t objects, tia_readable_register_t reg, uint8_t bit)
+{
+    int i;
+    for (i=0; i<TIA_OBJECT_CODES; i++) {
+        if ((i & objects) == objects) {
+            tia_collision_map[i] |= ((bit >> 6) << ((reg - TIA_READ_REG_CXM0P) * 2));
+        }
+    }
+}
+
+/* Finds the colour register shown when a combination of objects overlap.
+ *
+ * objects: code of the objects present
+ * priority: set if CTRLPF gives the playfield and ball priority
+ * mode: colour of the playfield
+ */
+static uint8_t TIA_resolve_priority(uint8_t objects, int priority, tia_playfield_mode_t mode)
+{
+    uint8_t playfield = TIA_WRITE_REG_COLUPF;
+    uint8_t colour = TIA_WRITE_REG_COLUBK;
+
+    if (mode == TIA_PLAYFIELD_SCORE_LEFT) {
+        playfield = TIA_WRITE_REG_COLUP0;
+    } else if (mode == TIA_PLAYFIELD_SCORE_RIGHT) {
+        playfield = TIA_WRITE_REG_COLUP1;
+    }
+
+    /* Default priority control:
+     * Highest: P0, M0
+     * Second:  P1, M1
+     * Third:   PF, BL
+     * Lowest:  BK
+     *
+     * Control register is specifying that priority be remapped to:
+     * Highest: PF, BL
+     * Second:  P0, M0
+     * Third:   P1, M1
+     * Lowest:  BK
+     */
+    if (objects & (TIA_OBJECT_P1 | TIA_OBJECT_M1)) {
+        colour = TIA_WRITE_REG_COLUP1;
+    }
+    if (objects & (TIA_OBJECT_P0 | TIA_OBJECT_M0)) {
+        colour = TIA_WRITE_REG_COLUP0;
+    }
+    if (!priority && (objects & (TIA_OBJECT_P0 | TIA_OBJECT_M0 | TIA_OBJECT_P1 | TIA_OBJECT_M1))) {
+        return colour;
+    }
+    if (objects & TIA_OBJECT_PF) {
+        colour = playfield;
+    }
+    if (objects & TIA_OBJECT_BL) {
+        /* The ball keeps its own colour in score mode */
+        colour = TIA_WRITE_REG_COLUPF;
+    }
+    return colour;
+}
+
 /* Resets the TIA instance to default conditions with no state set.
  */
 void TIA_init(void)
 {
     int i = 0;
+    tia_playfield_mode_t mode;
     /* Data registers */
     for (i=0; i<TIA_WRITE_REG_LEN; i++) {
         tia.write_regs[i] = 0;
@@ -350,6 +522,44 @@ void TIA_init(void)
     tia.missiles[1] = (tia_missile_t){0};
     tia.players[0] = (tia_player_t){0};
     tia.players[1] = (tia_player_t){0};
+
+    /* See page 41 of docs/Stella Programmer's Guide.pdf */
+    for (i=0; i<TIA_OBJECT_CODES; i++) {
+        tia_collision_map[i] = 0;
+    }
+    TIA_add_collision(TIA_OBJECT_M0 | TIA_OBJECT_P1, TIA_READ_REG_CXM0P, 0x80);
+    TIA_add_collision(TIA_OBJECT_M0 | TIA_OBJECT_P0, TIA_READ_REG_CXM0P, 0x40);
+    TIA_add_collision(TIA_OBJECT_M1 | TIA_OBJECT_P0, TIA_READ_REG_CXM1P, 0x80);
+    TIA_add_collision(TIA_OBJECT_M1 | TIA_OBJECT_P1, TIA_READ_REG_CXM1P, 0x40);
+    TIA_add_collision(TIA_OBJECT_P0 | TIA_OBJECT_PF, TIA_READ_REG_CXP0FB, 0x80);
+    TIA_add_collision(TIA_OBJECT_P0 | TIA_OBJECT_BL, TIA_READ_REG_CXP0FB, 0x40);
+    TIA_add_collision(TIA_OBJECT_P1 | TIA_OBJECT_PF, TIA_READ_REG_CXP1FB, 0x80);
+    TIA_add_collision(TIA_OBJECT_P1 | TIA_OBJECT_BL, TIA_READ_REG_CXP1FB, 0x40);
+    TIA_add_collision(TIA_OBJECT_M0 | TIA_OBJECT_PF, TIA_READ_REG_CXM0FB, 0x80);
+    TIA_add_collision(TIA_OBJECT_M0 | TIA_OBJECT_BL, TIA_READ_REG_CXM0FB, 0x40);
+    TIA_add_collision(TIA_OBJECT_M1 | TIA_OBJECT_PF, TIA_READ_REG_CXM1FB, 0x80);
+    TIA_add_collision(TIA_OBJECT_M1 | TIA_OBJECT_BL, TIA_READ_REG_CXM1FB, 0x40);
+    TIA_add_collision(TIA_OBJECT_BL | TIA_OBJECT_PF, TIA_READ_REG_CXBLPF, 0x80);
+    TIA_add_collision(TIA_OBJECT_P0 | TIA_OBJECT_P1, TIA_READ_REG_CXPPMM, 0x80);
+    TIA_add_collision(TIA_OBJECT_M0 | TIA_OBJECT_M1, TIA_READ_REG_CXPPMM, 0x40);
+
+    for (mode=TIA_PLAYFIELD_NORMAL; mode<TIA_PLAYFIELD_MODES; mode++) {
+        for (i=0; i<TIA_OBJECT_CODES; i++) {
+            tia_priority_map[mode][i] = TIA_resolve_priority(i, 0, mode);
+            tia_priority_map[mode][TIA_OBJECT_CODES + i] = TIA_resolve_priority(i, 1, mode);
+        }
+    }
+#ifdef DEFERRED_RENDERER
+    tia_render_clock = TIA_COLOUR_CLOCK_TOTAL;
+    tia_write_log_length = 0;
+#endif
+#ifdef SCANLINE_CACHE
+    for (i=0; i<TIA_SCANLINE_CACHE_ENTRIES; i++) {
+        tia_scanline_cache[i].valid = 0;
+    }
+    tia_scanline_cache_hits = 0;
+    tia_scanline_cache_misses = 0;
+#endif
 }
 
 /* Retrieves a value in a specified register
@@ -359,6 +569,16 @@ void TIA_init(void)
  */
 void TIA_read_register(uint8_t reg, uint8_t *value)
 {
+    if (reg >= TIA_READ_REG_LEN) {
+        /* Nothing drives the data bus, leave it as it was */
+        return;
+    }
+#ifdef DEFERRED_RENDERER
+    if (reg <= TIA_READ_REG_CXPPMM) {
+        /* Collisions are latched as the line is rendered */
+        TIA_render_pending();
+    }
+#endif
     *value = tia.read_regs[reg];
     // TODO remove after experiment
     if (reg == TIA_READ_REG_INPT4) {
@@ -366,12 +586,17 @@ void TIA_read_register(uint8_t reg, uint8_t *value)
     }
 }
 
-/* Writes a value into a register location
- *
- * reg: register to write to (e.g., CXM0P, CXM1P etc ...) value: value to place into register.
+/* Applies a value written into a register location to the TIA's state.
  */
-void TIA_write_register(uint8_t reg, uint8_t value)
+static void TIA_apply_write(uint8_t reg, uint8_t value)
 {
+    /* Only six address lines reach the TIA's write decoder, registers past
+     * CXCLR aren't implemented and writing them has no effect
+     */
+    reg &= 0x3F;
+    if (reg >= TIA_WRITE_REG_LEN) {
+        return;
+    }
     /* Perform special state logic on strobing registers which influence
      * state regardless of value written. E.g., writing a 0 to WSYNC still
      * results in the processor clock suspending
@@ -385,10 +610,17 @@ void TIA_write_register(uint8_t reg, uint8_t value)
         case TIA_WRITE_REG_PF1:
             /* Intentional fallthrough */
         case TIA_WRITE_REG_PF2:
-            /* Intentional fallthrough */
+            tia.write_regs[reg] = value;
+            TIA_update_playfield_register(reg);
+            break;
         case TIA_WRITE_REG_CTRLPF:
             tia.write_regs[reg] = value;
-            TIA_update_playfield();
+            /* Most writes change priority or ball size, leaving the
+             * playfield as it is
+             */
+            if (tia.playfield.mirror_enable != (value & 0x01)) {
+                TIA_update_playfield();
+            }
             break;
         case TIA_WRITE_REG_WSYNC:
             tia.write_regs[TIA_WRITE_REG_WSYNC] = 1;
@@ -472,6 +704,31 @@ void TIA_write_register(uint8_t reg, uint8_t value)
     }
 }
 
+/* Writes a value into a register location
+ *
+ * reg: register to write to (e.g., CXM0P, CXM1P etc ...) value: value to place into register.
+ */
+void TIA_write_register(uint8_t reg, uint8_t value)
+{
+#ifdef DEFERRED_RENDERER
+    if (reg == TIA_WRITE_REG_RSYNC) {
+        /* Restarting the line isn't replayed. The line so far is rendered
+         * and rendering resumes from the new colour clock.
+         */
+        TIA_render_pending();
+        TIA_apply_write(reg, value);
+        if (tia.colour_clock > TIA_COLOUR_CLOCK_HSYNC && tia.colour_clock < TIA_COLOUR_CLOCK_TOTAL) {
+            tia_render_clock = tia.colour_clock;
+        } else {
+            tia_render_clock = TIA_COLOUR_CLOCK_TOTAL;
+        }
+        return;
+    }
+    TIA_log_write(reg, value);
+#endif
+    TIA_apply_write(reg, value);
+}
+
 void TIA_reset_player(uint8_t player)
 {
     tia.players[player].scanline_reset = 1;
@@ -506,40 +763,29 @@ void TIA_update_missile_HMOVE(uint8_t missile)
 
 void TIA_update_player_buffer(uint8_t player)
 {
-    int position, mirror, pattern, i, pixel_clock, size_mask, draw_count;
+    const tia_player_size_t *size;
+    uint32_t pixels;
+    int position, i;
     tia_writable_register_t reflect_reg, graphics_reg, offset_reg, vertical_reg, size_reg;
 
-    TIA_reset_line_buffer(tia.players[player].line_buffer);
+    TIA_reset_line_mask(tia.players[player].line_mask);
     TIA_get_player_registers(player, &reflect_reg, &graphics_reg, &offset_reg, &vertical_reg, &size_reg);
 
-    mirror = (tia.write_regs[reflect_reg] & 0x8) ? 1 : 0;
-    position = tia.players[player].position_clock;
-
-    if (mirror) {
-        pattern = 0;
-        for (i=0; i<8; i++) {
-            pattern |= (tia.write_regs[graphics_reg] & (1 << i)) ? (1 << i) : 0;
-        }
-    } else {
-        pattern = tia.write_regs[graphics_reg];
+    pixels = tia_player_pixels[(tia.write_regs[reflect_reg] & 0x8) ? 1 : 0][tia.write_regs[graphics_reg]];
+    if (!pixels) {
+        return;
     }
 
-    size_mask = tia_player_size_map[(tia.write_regs[size_reg] & 0x7)];
-    draw_count = 8;
-    pixel_clock = 0;
+    position = tia.players[player].position_clock;
+    size = &tia_player_sizes[(tia.write_regs[size_reg] & 0x7)];
+    if (size->stretch == 2) {
+        pixels = tia_player_pixels_double[pixels];
+    } else if (size->stretch == 4) {
+        pixels = tia_playfield_cells[pixels];
+    }
 
-    for (i=0; i<TIA_COLOUR_CLOCK_VISIBLE; i++) {
-        if (i >= position) {
-            if ((draw_count > -1) && (size_mask & (1 << draw_count))) {
-                tia.players[player].line_buffer[i] = (pattern & (1 << pixel_clock) ? 1 : 0);
-            }
-            /* Every 8 clock cycles reset and start testing bits over */
-            pixel_clock++;
-            if (pixel_clock >= 8) {
-                draw_count--;
-                pixel_clock = 0;
-            }
-        }
+    for (i=0; i<size->copies; i++) {
+        TIA_set_line_mask_bits(tia.players[player].line_mask, pixels, position + size->offsets[i]);
     }
 }
 
@@ -574,10 +820,10 @@ void TIA_reset_missile(uint8_t missile)
 
 void TIA_update_missile_buffer(uint8_t missile)
 {
-    int position, i;
+    int position;
     tia_writable_register_t enable_reg, size_reg, offset_reg;
 
-    TIA_reset_line_buffer(tia.missiles[missile].line_buffer);
+    TIA_reset_line_mask(tia.missiles[missile].line_mask);
     TIA_get_missile_registers(missile, &enable_reg, &size_reg, &offset_reg);
 
     if (!tia.write_regs[enable_reg]) {
@@ -587,11 +833,9 @@ void TIA_update_missile_buffer(uint8_t missile)
     position = tia.missiles[missile].position_clock;
     tia.missiles[missile].width = (1 << (tia.write_regs[size_reg] >> 4));
 
-    for (i=0; i<TIA_COLOUR_CLOCK_VISIBLE; i++) {
-        if ((i >= position) && (i <= (position + tia.missiles[missile].width))) {
-            tia.missiles[missile].line_buffer[i] = 1;
-        }
-    }
+    /* N.B. the width is inclusive of the clock the missile starts on */
+    TIA_set_line_mask_range(tia.missiles[missile].line_mask, position,
+            position + tia.missiles[missile].width + 1);
 }
 
 void TIA_get_playfield_pattern(uint32_t *playfield)
@@ -604,21 +848,77 @@ void TIA_get_playfield_pattern(uint32_t *playfield)
 
 void TIA_update_playfield()
 {
-    uint32_t pattern, i;
-    TIA_get_playfield_pattern(&pattern);
     tia.playfield.mirror_enable = (tia.write_regs[TIA_WRITE_REG_CTRLPF] & 0x01) ? 1 : 0;
-    /* Fill in the first half of the screen */
-    for (i=0; i<TIA_COLOUR_CLOCK_VISIBLE_HALF; i++) {
-        /* N.B divide by four as each playfield bit covers four TIA clock cycles */
-        tia.playfield.line_buffer[i] = ((pattern & (1 << (i/4))) ? 1 : 0);
-    }
-    /* Now fill in the second-half, compensating if mirroring has been enabled */
-    for (i=0; i<TIA_COLOUR_CLOCK_VISIBLE_HALF; i++) {
-        if (tia.playfield.mirror_enable) {
-            tia.playfield.line_buffer[i+TIA_COLOUR_CLOCK_VISIBLE_HALF] = ((pattern & (0x80000 >> (i/4))) ? 1 : 0);
-        } else {
-            tia.playfield.line_buffer[i+TIA_COLOUR_CLOCK_VISIBLE_HALF] = ((pattern & (1 << (i/4))) ? 1 : 0);
-        }
+    TIA_update_playfield_register(TIA_WRITE_REG_PF0);
+    TIA_update_playfield_register(TIA_WRITE_REG_PF1);
+    TIA_update_playfield_register(TIA_WRITE_REG_PF2);
+}
+
+/* Replaces 16 clocks of the playfield's line mask, i.e., four cells.
+ *
+ * half: index of the 16 clocks within the line
+ * cells: mask of the clocks to set
+ */
+static void TIA_set_playfield_cells(int half, uint32_t cells)
+{
+    uint32_t *word = &tia.playfield.line_mask[half >> 1];
+    int shift = (half & 1) * 16;
+
+    *word = (*word & ~(0xFFFFu << shift)) | ((cells & 0xFFFF) << shift);
+}
+
+/* Updates only those cells of the playfield drawn from one register. Each
+ * playfield bit covers four TIA clock cycles, so a register's cells span
+ * whole halves of the mask's words: PF0 one half and PF1 and PF2 two each,
+ * on each side of the screen.
+ *
+ * reg: PF0, PF1 or PF2
+ */
+void TIA_update_playfield_register(tia_writable_register_t reg)
+{
+    uint8_t value = tia.write_regs[reg];
+    uint32_t cells, reflected;
+
+    if (reg == TIA_WRITE_REG_PF0) {
+        /* Only the upper nibble is used */
+        value >>= 4;
+    }
+    cells = tia_playfield_cells[value];
+    reflected = tia_playfield_cells_reflected[value];
+
+    switch (reg) {
+        case TIA_WRITE_REG_PF0:
+            TIA_set_playfield_cells(0, cells);
+            if (tia.playfield.mirror_enable) {
+                TIA_set_playfield_cells(9, reflected >> 16);
+            } else {
+                TIA_set_playfield_cells(5, cells);
+            }
+            break;
+        case TIA_WRITE_REG_PF1:
+            TIA_set_playfield_cells(1, cells);
+            TIA_set_playfield_cells(2, cells >> 16);
+            if (tia.playfield.mirror_enable) {
+                TIA_set_playfield_cells(7, reflected);
+                TIA_set_playfield_cells(8, reflected >> 16);
+            } else {
+                TIA_set_playfield_cells(6, cells);
+                TIA_set_playfield_cells(7, cells >> 16);
+            }
+            break;
+        case TIA_WRITE_REG_PF2:
+            TIA_set_playfield_cells(3, cells);
+            TIA_set_playfield_cells(4, cells >> 16);
+            if (tia.playfield.mirror_enable) {
+                TIA_set_playfield_cells(5, reflected);
+                TIA_set_playfield_cells(6, reflected >> 16);
+            } else {
+                TIA_set_playfield_cells(8, cells);
+                TIA_set_playfield_cells(9, cells >> 16);
+            }
+            break;
+        default:
+            break;
     }
 }
 
@@ -627,7 +927,7 @@ int TIA_test_playfield_bit()
     if (tia.colour_clock < TIA_COLOUR_CLOCK_HSYNC) {
         return 0;
     }
-    return (tia.playfield.line_buffer[tia.colour_clock - TIA_COLOUR_CLOCK_HSYNC] ? 1 : 0);
+    return TIA_test_line_mask(tia.playfield.line_mask, tia.colour_clock - TIA_COLOUR_CLOCK_HSYNC);
 }
 
 int TIA_test_missile_bit(uint8_t missile)
@@ -635,7 +935,7 @@ int TIA_test_missile_bit(uint8_t missile)
     if (tia.colour_clock < TIA_COLOUR_CLOCK_HSYNC) {
         return 0;
     }
-    return (tia.missiles[missile].line_buffer[tia.colour_clock - TIA_COLOUR_CLOCK_HSYNC] ? 1 : 0);
+    return TIA_test_line_mask(tia.missiles[missile].line_mask, tia.colour_clock - TIA_COLOUR_CLOCK_HSYNC);
 }
 
 int TIA_test_player_bit(uint8_t player)
@@ -643,7 +943,7 @@ int TIA_test_player_bit(uint8_t player)
     if (tia.colour_clock < TIA_COLOUR_CLOCK_HSYNC) {
         return 0;
     }
-    return (tia.players[player].line_buffer[tia.colour_clock - TIA_COLOUR_CLOCK_HSYNC] ? 1 : 0);
+    return TIA_test_line_mask(tia.players[player].line_mask, tia.colour_clock - TIA_COLOUR_CLOCK_HSYNC);
 }
 
 void TIA_apply_HMOVE(tia_writable_register_t offset_reg, int *position)
@@ -668,67 +968,63 @@ uint8_t TIA_reverse_byte(uint8_t byte)
     return byte;
 }
 
+/* Returns the code of the objects present on the current colour clock */
+uint8_t TIA_get_objects(void)
+{
+    int index = tia.colour_clock - TIA_COLOUR_CLOCK_HSYNC;
+    int word = index >> 5;
+    int shift = index & 31;
+
+    return ((tia.players[0].line_mask[word] >> shift) & 1) |
+           (((tia.players[1].line_mask[word] >> shift) & 1) << 1) |
+           (((tia.missiles[0].line_mask[word] >> shift) & 1) << 2) |
+           (((tia.missiles[1].line_mask[word] >> shift) & 1) << 3) |
+           (((tia.playfield.line_mask[word] >> shift) & 1) << 5);
+}
+
+/* Sets the collision latches for collisions found while generating colours
+ *
+ * collisions: bits from tia_collision_map
+ */
+void TIA_latch_collisions(uint16_t collisions)
+{
+    int reg;
+    for (reg=TIA_READ_REG_CXM0P; reg<=TIA_READ_REG_CXPPMM; reg++) {
+        tia.read_regs[reg] |= ((collisions & 0x3) << 6);
+        collisions >>= 2;
+    }
+}
+
 void TIA_generate_colour(void)
 {
-    /* Grab the background. If there's an element on the same clock count
-     * we'll overwrite it
-     */
-    tia_pixel_t pixel = {0};
-    TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUBK], &pixel);
+    uint8_t objects = TIA_get_objects();
 
-    /* TODO check order of priority established in PFB bits
-     * to establish if playfield need to be rendered over player
-     * objects
-     */
-    if (tia.write_regs[TIA_WRITE_REG_CTRLPF] & 0x04) {
-        /* Control register is specifying that priority be remapped to:
-         * Highest: PF, BL
-         * Second:  P0, M0
-         * Third:   P1, M1
-         * Lowest:  BK
-         */
-        if (TIA_test_missile_bit(1)) {
-            TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUP0], &pixel);
-        }
-        if (TIA_test_player_bit(1)) {
-            TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUP1], &pixel);
-        }
-        if (TIA_test_missile_bit(0)) {
-            TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUP0], &pixel);
-        }
-        if (TIA_test_player_bit(0)) {
-            TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUP0], &pixel);
-        }
-        if (TIA_test_playfield_bit()) {
-            TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUPF], &pixel);
-        }
-    } else {
-        /* Default priority control:
-         * Highest: P0, M0
-         * Second:  P1, M1
-         * Third:   PF, BL
-         * Lowest:  BK
-         */
-        if (TIA_test_playfield_bit()) {
-            TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUPF], &pixel);
-        }
-        if (TIA_test_missile_bit(1)) {
-            TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUP1], &pixel);
-        }
-        if (TIA_test_player_bit(1)) {
-            TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUP1], &pixel);
-        }
-        if (TIA_test_missile_bit(0)) {
-            TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUP0], &pixel);
-        }
-        if (TIA_test_player_bit(0)) {
-            TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUP0], &pixel);
-        }
+    TIA_draw_objects(objects);
+    /* Only clocks with more than one object present can collide */
+    if (objects & (objects - 1)) {
+        TIA_latch_collisions(tia_collision_map[objects]);
     }
+}
 
-    TIA_write_to_buffer(pixel, (tia.colour_clock-TIA_COLOUR_CLOCK_HSYNC));
+/* Writes the colour of the current colour clock to the line buffer
+ *
+ * objects: code of the objects present on the clock
+ */
+void TIA_draw_objects(uint8_t objects)
+{
+    tia_pixel_t pixel = {0};
+    int index = tia.colour_clock - TIA_COLOUR_CLOCK_HSYNC;
+    uint8_t control = tia.write_regs[TIA_WRITE_REG_CTRLPF];
+    int mode, priority;
 
-    /* TODO check for collisions and set registers appropriately */
+    /* Computed without branching. Score mode only applies without
+     * playfield priority, and selects a player's colour by screen half.
+     */
+    mode = ((control & (TIA_CTRLPF_SCORE | TIA_CTRLPF_PRIORITY)) == TIA_CTRLPF_SCORE) *
+        (TIA_PLAYFIELD_SCORE_LEFT + (index >= TIA_COLOUR_CLOCK_VISIBLE_HALF));
+    priority = (control & TIA_CTRLPF_PRIORITY) ? TIA_OBJECT_CODES : 0;
+    TIA_colour_to_RGB(tia.write_regs[tia_priority_map[mode][priority | objects]], &pixel);
+    TIA_write_to_buffer(pixel, index);
 }
 
 void TIA_write_to_buffer(tia_pixel_t pixel, int pixel_index)
@@ -765,18 +1061,300 @@ int TIA_clock_tick()
         TIA_update_player_buffer(1);
         TIA_update_missile_buffer(0);
         TIA_update_missile_buffer(1);
+#ifdef DEFERRED_RENDERER
+        tia_render_clock = TIA_COLOUR_CLOCK_HSYNC + 1;
+#endif
     }
     if (tia.colour_clock > TIA_COLOUR_CLOCK_HSYNC) {
+#ifndef DEFERRED_RENDERER
         TIA_generate_colour();
+#endif
     } else {
         /* Horizontal or vertical sync time, no need to generate a colour */
     }
     tia.colour_clock++;
+#ifdef DEFERRED_RENDERER
+    if (tia.colour_clock == TIA_COLOUR_CLOCK_TOTAL) {
+        TIA_render_pending();
+    }
+#endif
+    return tia.colour_clock;
+}
+
+/* Generates the colour of a run of visible clocks, leaving the TIA exactly
+ * as if TIA_clock_tick() had been called for each. The object masks are
+ * combined a word at a time, and pixels no object covers are filled with the
+ * background without testing priorities. Collisions are only looked up for
+ * pixels covered by more than one object, and latched once per word.
+ *
+ * clocks: number of colour clocks to generate, not beyond the end of the line
+ */
+static void TIA_generate_span(int clocks)
+{
+    tia_pixel_t background = {0};
+    uint32_t objects, overlap, mask;
+    uint16_t collisions;
+    uint8_t present;
+    int index, word, run;
+
+    TIA_colour_to_RGB(tia.write_regs[TIA_WRITE_REG_COLUBK], &background);
+
+    while (clocks > 0) {
+        index = tia.colour_clock - TIA_COLOUR_CLOCK_HSYNC;
+        word = index >> 5;
+        run = 32 - (index & 31);
+        if (run > clocks) {
+            run = clocks;
+        }
+        clocks -= run;
+
+        /* Gather the clocks covered by any object, and by two or more */
+        objects = tia.players[0].line_mask[word];
+        mask = tia.players[1].line_mask[word];
+        overlap = objects & mask;
+        objects |= mask;
+        mask = tia.missiles[0].line_mask[word];
+        overlap |= objects & mask;
+        objects |= mask;
+        mask = tia.missiles[1].line_mask[word];
+        overlap |= objects & mask;
+        objects |= mask;
+        mask = tia.playfield.line_mask[word];
+        overlap |= objects & mask;
+        objects |= mask;
+        objects >>= (index & 31);
+        overlap >>= (index & 31);
+
+        collisions = 0;
+        while (run--) {
+            if (objects & 1) {
+                present = TIA_get_objects();
+                TIA_draw_objects(present);
+                if (overlap & 1) {
+                    collisions |= tia_collision_map[present];
+                }
+            } else {
+                TIA_write_to_buffer(background, tia.colour_clock-TIA_COLOUR_CLOCK_HSYNC);
+            }
+            objects >>= 1;
+            overlap >>= 1;
+            tia.colour_clock++;
+        }
+        if (collisions) {
+            TIA_latch_collisions(collisions);
+        }
+    }
+}
+
+#ifdef DEFERRED_RENDERER
+/* Records a register write for the line being rendered */
+static void TIA_log_write(uint8_t reg, uint8_t value)
+{
+    if (tia.colour_clock <= TIA_COLOUR_CLOCK_HSYNC || tia.colour_clock >= TIA_COLOUR_CLOCK_TOTAL) {
+        /* Outside the visible part of the line, so taken up in the state
+         * rendering next starts from
+         */
+        return;
+    }
+    if (tia_write_log_length == TIA_WRITE_LOG_LENGTH) {
+        TIA_render_pending();
+    }
+    if (!tia_write_log_length) {
+        tia_line_state = tia;
+    }
+    tia_write_log[tia_write_log_length].colour_clock = tia.colour_clock;
+    tia_write_log[tia_write_log_length].reg = reg;
+    tia_write_log[tia_write_log_length].value = value;
+    tia_write_log_length++;
+}
+
+/* Renders the pixels of the line up to the current colour clock */
+static void TIA_render_pending(void)
+{
+    atari_tia live;
+    int i, end, colour_clock;
+
+    end = (tia.colour_clock < TIA_COLOUR_CLOCK_TOTAL) ? tia.colour_clock : TIA_COLOUR_CLOCK_TOTAL;
+    if (end <= tia_render_clock) {
+        return;
+    }
+
+    if (!tia_write_log_length) {
+        /* Nothing changed, the whole span is drawn from the current state */
+        colour_clock = tia.colour_clock;
+        tia.colour_clock = tia_render_clock;
+#ifdef SCANLINE_CACHE
+        TIA_render_cached(end - tia_render_clock);
+#else
+        TIA_generate_span(end - tia_render_clock);
+#endif
+        tia.colour_clock = colour_clock;
+    } else {
+        live = tia;
+        tia = tia_line_state;
+        tia.colour_clock = tia_render_clock;
+        for (i=0; i<tia_write_log_length; i++) {
+            TIA_generate_span(tia_write_log[i].colour_clock - tia.colour_clock);
+            TIA_apply_write(tia_write_log[i].reg, tia_write_log[i].value);
+        }
+        TIA_generate_span(end - tia.colour_clock);
+        /* Keep the collisions latched along the way */
+        for (i=TIA_READ_REG_CXM0P; i<=TIA_READ_REG_CXPPMM; i++) {
+            live.read_regs[i] = tia.read_regs[i];
+        }
+        tia = live;
+        tia_write_log_length = 0;
+    }
+    tia_render_clock = end;
+}
+#endif /* DEFERRED_RENDERER */
+
+#ifdef SCANLINE_CACHE
+/* Gathers the state a line's pixels are generated from */
+static uint32_t TIA_get_scanline_key(tia_scanline_key_t *key)
+{
+    const uint32_t *word;
+    uint32_t hash = 2166136261u;
+    int i;
+
+    /* Cleared so padding compares equal */
+    memset(key, 0, sizeof(*key));
+    memcpy(key->line_masks[0], tia.players[0].line_mask, sizeof(tia_line_mask_t));
+    memcpy(key->line_masks[1], tia.players[1].line_mask, sizeof(tia_line_mask_t));
+    memcpy(key->line_masks[2], tia.missiles[0].line_mask, sizeof(tia_line_mask_t));
+    memcpy(key->line_masks[3], tia.missiles[1].line_mask, sizeof(tia_line_mask_t));
+    memcpy(key->line_masks[4], tia.playfield.line_mask, sizeof(tia_line_mask_t));
+    /* Bit 0 of the colour registers is unused */
+    key->colours[0] = tia.write_regs[TIA_WRITE_REG_COLUP0] & 0xFE;
+    key->colours[1] = tia.write_regs[TIA_WRITE_REG_COLUP1] & 0xFE;
+    key->colours[2] = tia.write_regs[TIA_WRITE_REG_COLUPF] & 0xFE;
+    key->colours[3] = tia.write_regs[TIA_WRITE_REG_COLUBK] & 0xFE;
+    key->control = tia.write_regs[TIA_WRITE_REG_CTRLPF] & (TIA_CTRLPF_SCORE | TIA_CTRLPF_PRIORITY);
+
+    /* FNV-1a, a word at a time */
+    word = (const uint32_t *)key;
+    for (i=0; i<sizeof(*key)/sizeof(uint32_t); i++) {
+        hash = (hash ^ word[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/* Generates a span of clocks drawn from unchanging state, copying it from
+ * the cache if a line has already been rendered from the same state. Only
+ * whole lines are added to the cache, and the collisions they latched are
+ * kept with them, so a part of a line is only copied if it has none.
+ *
+ * clocks: number of colour clocks to generate, not beyond the end of the line
+ */
+static void TIA_render_cached(int clocks)
+{
+    tia_scanline_key_t key;
+    tia_scanline_t *line;
+    uint8_t latched[TIA_READ_REG_CXPPMM + 1];
+    int start = tia.colour_clock - TIA_COLOUR_CLOCK_HSYNC;
+    int whole = (tia.colour_clock == TIA_COLOUR_CLOCK_HSYNC + 1) &&
+                (clocks == TIA_COLOUR_CLOCK_TOTAL - TIA_COLOUR_CLOCK_HSYNC - 1);
+    int reg;
+
+    line = &tia_scanline_cache[TIA_get_scanline_key(&key) % TIA_SCANLINE_CACHE_ENTRIES];
+    if (line->valid && !memcmp(&line->key, &key, sizeof(key)) && (whole || !line->collisions)) {
+        memcpy(&tia_line_buffer[start], &line->pixels[start], clocks * sizeof(tia_pixel_t));
+        if (line->collisions) {
+            TIA_latch_collisions(line->collisions);
+        }
+        tia.colour_clock += clocks;
+        tia_scanline_cache_hits++;
+        return;
+    }
+    tia_scanline_cache_misses++;
+    if (!whole) {
+        TIA_generate_span(clocks);
+        return;
+    }
+
+    /* Latch the line's collisions alone to keep a record of them */
+    for (reg=TIA_READ_REG_CXM0P; reg<=TIA_READ_REG_CXPPMM; reg++) {
+        latched[reg] = tia.read_regs[reg];
+        tia.read_regs[reg] = 0;
+    }
+    TIA_generate_span(clocks);
+    line->collisions = 0;
+    for (reg=TIA_READ_REG_CXPPMM; reg>=TIA_READ_REG_CXM0P; reg--) {
+        line->collisions = (line->collisions << 2) | ((tia.read_regs[reg] >> 6) & 0x3);
+        tia.read_regs[reg] |= latched[reg];
+    }
+    memcpy(&line->pixels[start], &tia_line_buffer[start], clocks * sizeof(tia_pixel_t));
+    line->key = key;
+    line->valid = 1;
+}
+
+/* Reports how often spans were copied from the scanline cache
+ *
+ * *hits: location to place the number of spans copied from the cache
+ * *misses: location to place the number of spans generated
+ */
+void TIA_get_scanline_cache_stats(uint32_t *hits, uint32_t *misses)
+{
+    *hits = tia_scanline_cache_hits;
+    *misses = tia_scanline_cache_misses;
+}
+#endif /* SCANLINE_CACHE */
+
+/* Advances the TIA by a number of colour clocks at once, leaving it exactly
+ * as if TIA_clock_tick() had been called that many times. Clocks during
+ * horizontal blank generate nothing so are skipped over in one go, and
+ * visible clocks are generated a run at a time.
+ *
+ * clocks: number of colour clocks to advance
+ */
+void TIA_advance(int clocks)
+{
+    int step;
+
+    while (clocks > 0) {
+        if (tia.colour_clock >= TIA_COLOUR_CLOCK_TOTAL) {
+            TIA_clock_tick();
+            clocks--;
+        } else if (tia.colour_clock < TIA_COLOUR_CLOCK_HSYNC) {
+            step = TIA_COLOUR_CLOCK_HSYNC - tia.colour_clock;
+            if (step > clocks) {
+                step = clocks;
+            }
+            tia.colour_clock += step;
+            clocks -= step;
+        } else if (tia.colour_clock == TIA_COLOUR_CLOCK_HSYNC) {
+            /* Object masks are built for the line on this clock */
+            TIA_clock_tick();
+            clocks--;
+        } else {
+            step = TIA_COLOUR_CLOCK_TOTAL - tia.colour_clock;
+            if (step > clocks) {
+                step = clocks;
+            }
+            clocks -= step;
+#ifdef DEFERRED_RENDERER
+            tia.colour_clock += step;
+            if (tia.colour_clock == TIA_COLOUR_CLOCK_TOTAL) {
+                TIA_render_pending();
+            }
+#else
+            TIA_generate_span(step);
+#endif
+        }
+    }
+}
+
+/* Returns the colour clock reached within the current line */
+int TIA_get_colour_clock()
+{
     return tia.colour_clock;
 }
 
 int TIA_draw_line(int line_count)
 {
+#ifdef DEFERRED_RENDERER
+    TIA_render_pending();
+#endif
     ili9341_draw_line(tia_line_buffer, line_count, ATARI_RESOLUTION_WIDTH);
 }
 
@@ -795,17 +1373,73 @@ int TIA_get_VBLANK()
     return (tia.write_regs[TIA_WRITE_REG_VBLANK] ? 1 : 0);
 }
 
-void TIA_reset_line_buffer(uint8_t line_buffer[])
+void TIA_reset_line_mask(tia_line_mask_t line_mask)
 {
     int i;
-    for (i=0; i<TIA_COLOUR_CLOCK_VISIBLE; i++) {
-        line_buffer[i] = 0;
+    for (i=0; i<TIA_LINE_MASK_WORDS; i++) {
+        line_mask[i] = 0;
     }
 }
 
+/* Sets the bits of a line mask covering a range of visible clocks, clipped
+ * to the right edge of the line.
+ *
+ * start: first clock set
+ * end: clock after the last set
+ */
+void TIA_set_line_mask_range(tia_line_mask_t line_mask, int start, int end)
+{
+    int word, last;
+    uint32_t bits;
+
+    if (end > TIA_COLOUR_CLOCK_VISIBLE) {
+        end = TIA_COLOUR_CLOCK_VISIBLE;
+    }
+    while (start < end) {
+        word = start >> 5;
+        last = (word + 1) << 5;
+        if (last > end) {
+            last = end;
+        }
+        /* Bits from start up to (but not including) last within this word */
+        bits = (last - start == 32) ? 0xFFFFFFFF : (((1u << (last - start)) - 1) << (start & 31));
+        line_mask[word] |= bits;
+        start = last;
+    }
+}
+
+/* Sets up to 32 bits of a line mask, least significant bit first, dropping
+ * any which fall beyond the right edge of the line.
+ *
+ * bits: pattern to set
+ * start: clock of the first bit
+ */
+void TIA_set_line_mask_bits(tia_line_mask_t line_mask, uint32_t bits, int start)
+{
+    int word = start >> 5;
+    int shift = start & 31;
+
+    if (start < 0 || word >= TIA_LINE_MASK_WORDS) {
+        return;
+    }
+    line_mask[word] |= (bits << shift);
+    if (shift && (word + 1) < TIA_LINE_MASK_WORDS) {
+        line_mask[word+1] |= (bits >> (32 - shift));
+    }
+}
+
+/* Returns 1 if a line mask covers a visible clock */
+int TIA_test_line_mask(const tia_line_mask_t line_mask, int index)
+{
+    return (line_mask[index >> 5] >> (index & 31)) & 1;
+}
+
 int TIA_reset_buffer()
 {
     int i;
+#ifdef DEFERRED_RENDERER
+    TIA_render_pending();
+#endif
     for (i=0; i<ATARI_RESOLUTION_WIDTH; i++) {
         tia_line_buffer[i].R = 0x0;
         tia_line_buffer[i].G = 0x0;
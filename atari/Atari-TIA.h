@@ -96,18 +96,51 @@ typedef enum {
     TIA_READ_REG_LEN
 } tia_readable_register_t;
 
+/* Each object's coverage of the visible line is held as a mask of one bit
+ * per colour clock, bit 0 of the first word being the leftmost pixel.
+ */
+#define TIA_LINE_MASK_WORDS (TIA_COLOUR_CLOCK_VISIBLE / 32)
+
+typedef uint32_t tia_line_mask_t[TIA_LINE_MASK_WORDS];
+
+/* Objects present on a colour clock, as bits of a 6-bit code */
+typedef enum {
+    TIA_OBJECT_P0 = 0x01, /* Player 0 */
+    TIA_OBJECT_P1 = 0x02, /* Player 1 */
+    TIA_OBJECT_M0 = 0x04, /* Missile 0 */
+    TIA_OBJECT_M1 = 0x08, /* Missile 1 */
+    TIA_OBJECT_BL = 0x10, /* Ball */
+    TIA_OBJECT_PF = 0x20  /* Playfield */
+} tia_object_t;
+
+#define TIA_OBJECT_CODES 64
+
+/* CTRLPF bits affecting which object's colour is shown */
+#define TIA_CTRLPF_SCORE    0x02
+#define TIA_CTRLPF_PRIORITY 0x04
+
+/* Colour of the playfield, which in score mode takes that of the player on
+ * the same half of the screen.
+ */
+typedef enum {
+    TIA_PLAYFIELD_NORMAL = 0,   /* COLUPF */
+    TIA_PLAYFIELD_SCORE_LEFT,   /* COLUP0 */
+    TIA_PLAYFIELD_SCORE_RIGHT,  /* COLUP1 */
+    TIA_PLAYFIELD_MODES
+} tia_playfield_mode_t;
+
 typedef struct {
     uint8_t scanline_reset;
     uint8_t enabled;
     uint32_t position_clock;
     uint8_t width;
     uint8_t horizontal_offset;
-    uint8_t line_buffer[TIA_COLOUR_CLOCK_VISIBLE];
+    tia_line_mask_t line_mask;
 } tia_missile_t;
 
 typedef struct {
     uint8_t mirror_enable;
-    uint8_t line_buffer[TIA_COLOUR_CLOCK_VISIBLE];
+    tia_line_mask_t line_mask;
 } tia_playfield_t;
 
 typedef struct {
@@ -116,9 +149,18 @@ typedef struct {
     uint8_t horizontal_offset;
     uint8_t vertical_delay;
     uint8_t pattern;
-    uint8_t line_buffer[TIA_COLOUR_CLOCK_VISIBLE];
+    tia_line_mask_t line_mask;
 } tia_player_t;
 
+/* Copies of a player drawn for each NUSIZx setting */
+#define TIA_PLAYER_MAX_COPIES 3
+
+typedef struct {
+    uint8_t copies;                          /* Number of copies drawn */
+    uint8_t offsets[TIA_PLAYER_MAX_COPIES];  /* Clocks from the player's position to each copy */
+    uint8_t stretch;                         /* Clocks per pixel */
+} tia_player_size_t;
+
 /* Define a structure type to represent the state of a TIA chip */
 typedef struct {
     // Data registers
@@ -140,7 +182,17 @@ extern tia_pixel_t tia_colour_map[128];
 #ifdef COLOUR_TEST
 extern tia_pixel_t tia_test_line[TIA_COLOUR_CLOCK_VISIBLE];
 #endif /* COLOUR_TEST */
-extern uint8_t tia_player_size_map[8];
+extern const tia_player_size_t tia_player_sizes[8];
+
+/* Collision latches set by each combination of objects, two bits (D7, D6)
+ * per register from CXM0P upwards.
+ */
+extern uint16_t tia_collision_map[TIA_OBJECT_CODES];
+
+/* Colour register shown for each combination of objects, indexed by the
+ * objects present with CTRLPF's priority bit above them.
+ */
+extern uint8_t tia_priority_map[TIA_PLAYFIELD_MODES][TIA_OBJECT_CODES * 2];
 
 /* This is the single instance of atari_tia type to represent
  * the TIA in this application */
@@ -151,12 +203,28 @@ extern atari_tia tia;
  */
 extern tia_pixel_t tia_line_buffer[TIA_COLOUR_CLOCK_VISIBLE];
 
+#ifdef SCANLINE_CACHE
+/* Rendered lines are direct mapped by a hash of the state they were rendered
+ * from, with room on the FE310 for a handful only.
+ */
+#ifdef HOST_BUILD
+    #define TIA_SCANLINE_CACHE_ENTRIES 64
+#else
+    #define TIA_SCANLINE_CACHE_ENTRIES 4
+#endif
+#endif /* SCANLINE_CACHE */
+
 /* Interfacing functions */
 void TIA_init(void);
 void TIA_read_register(uint8_t reg, uint8_t *value);
 void TIA_write_register(uint8_t reg, uint8_t value);
 int TIA_clock_tick(void);
+void TIA_advance(int clocks);
+int TIA_get_colour_clock(void);
 void TIA_generate_colour(void);
+uint8_t TIA_get_objects(void);
+void TIA_draw_objects(uint8_t objects);
+void TIA_latch_collisions(uint16_t collisions);
 int TIA_get_WSYNC(void);
 int TIA_get_VSYNC(void);
 int TIA_get_VBLANK(void);
@@ -164,7 +232,10 @@ void TIA_write_to_buffer(tia_pixel_t pixel, int pixel_index);
 void TIA_colour_to_RGB(uint8_t tia_colour, tia_pixel_t* pixel);
 int TIA_draw_line(int line_count);
 int TIA_reset_buffer();
-void TIA_reset_line_buffer(uint8_t line_buffer[]);
+void TIA_reset_line_mask(tia_line_mask_t line_mask);
+void TIA_set_line_mask_range(tia_line_mask_t line_mask, int start, int end);
+void TIA_set_line_mask_bits(tia_line_mask_t line_mask, uint32_t bits, int start);
+int TIA_test_line_mask(const tia_line_mask_t line_mask, int index);
 uint8_t TIA_reverse_byte(uint8_t byte);
 int TIA_test_playfield_bit();
 void TIA_get_playfield_pattern(uint32_t *playfield);
@@ -172,6 +243,7 @@ void TIA_reset_missile(uint8_t missile);
 void TIA_update_missile_buffer(uint8_t missile);
 void TIA_update_player_buffer(uint8_t player);
 void TIA_update_playfield();
+void TIA_update_playfield_register(tia_writable_register_t reg);
 int TIA_test_player_bit(uint8_t player);
 void TIA_reset_player(uint8_t player);
 void TIA_get_player_registers(uint8_t player, tia_writable_register_t *reflect,
@@ -182,5 +254,8 @@ void TIA_get_missile_registers(uint8_t missile, tia_writable_register_t *enable,
 void TIA_apply_HMOVE(tia_writable_register_t offset_reg, int *position);
 void TIA_update_player_HMOVE(uint8_t player);
 void TIA_update_missile_HMOVE(uint8_t missile);
+#ifdef SCANLINE_CACHE
+void TIA_get_scanline_cache_stats(uint32_t *hits, uint32_t *misses);
+#endif /* SCANLINE_CACHE */
 
 #endif /* _ATARI_TIA_H */
@@ -7,6 +7,20 @@
  */
 
 #include "Atari-cart.h"
+#include "Atari-memmap.h"
+#include "mos6507/mos6507-decode-cache.h"
+#ifdef THREADED_CODE
+    #include "mos6507/mos6507-threaded.h"
+#endif
+#ifdef AOT_CODE
+    #include "mos6507/mos6507-aot.h"
+#endif
+#ifdef DYNAREC
+    #include "mos6507/mos6507-dynarec.h"
+#endif
+#ifdef SUPERINSTRUCTIONS
+    #include "mos6507/mos6507-superinstructions.h"
+#endif
 
 /* Cartridges are represented as arrays of bytes in their own
  * part of memory. We "load" a cartridge by storing a pointer 
@@ -27,11 +41,37 @@ void cartridge_load(const uint8_t *cart)
         cartridge_eject();
     }
     cartridge = cart;
+    memmap_map_cartridge(cartridge);
+    decode_cache_invalidate();
+#ifdef THREADED_CODE
+    threaded_invalidate();
+#endif
+#ifdef DYNAREC
+    dynarec_invalidate();
+#endif
+#ifdef SUPERINSTRUCTIONS
+    superinstruction_invalidate();
+#endif
 }
 
 void cartridge_eject(void)
 {
     /* Clear the pointer to the current cartridge array */
     cartridge = 0;
+    memmap_map_cartridge(cartridge);
+    /* Instructions decoded from the old cartridge no longer apply */
+    decode_cache_invalidate();
+#ifdef AOT_CODE
+    aot_load(0);
+#endif
+#ifdef THREADED_CODE
+    threaded_invalidate();
+#endif
+#ifdef DYNAREC
+    dynarec_invalidate();
+#endif
+#ifdef SUPERINSTRUCTIONS
+    superinstruction_invalidate();
+#endif
 }
 
@@ -14,13 +14,247 @@
 #include "Atari-TIA.h"
 #include "mos6507/mos6507.h"
 #include "mos6532/mos6532.h"
+#ifdef ATOMIC_INSTRUCTIONS
+    #include "external/platform_util.h"
+#endif
+#ifdef SKIP_IDLE_LOOPS
+    #include "mos6507/mos6507-decode-cache.h"
+#endif
 
-#define IS_TIA(x)  (x >= MEMMAP_TIA_START && x <= MEMMAP_TIA_END)
-#define IS_RIOT(x) ((x >= MEMMAP_RIOT_RAM_START && x <= MEMMAP_RIOT_RAM_END) || \
-                    (x >= MEMMAP_RIOT_RAM_MIRROR_START && x <= MEMMAP_RIOT_RAM_MIRROR_END) || \
-                    (x >= MEMMAP_RIOT_PERIPH_START && x <= MEMMAP_RIOT_PERIPH_END) || \
-                    (x >= MEMMAP_RIOT_PERIPH_MIRROR_START && x <= MEMMAP_RIOT_PERIPH_MIRROR_END))
-#define IS_CART(x) (x >= MEMMAP_CART_START && x <= MEMMAP_CART_END)
+/* The 13-bit address space is decoded through a table of 128 byte pages.
+ * Each page either points directly at the memory backing it (RIOT RAM,
+ * cartridge ROM) or names a handler for the device mapped there (TIA, RIOT
+ * I/O). Mirrors are resolved as the table is built, so an access is a single
+ * indexed load rather than a chain of range checks. Reads from unmapped
+ * pages leave the data unchanged.
+ */
+#define MEMMAP_PAGE_SHIFT 7
+#define MEMMAP_PAGE_SIZE  (1 << MEMMAP_PAGE_SHIFT)
+#define MEMMAP_PAGE_MASK  (MEMMAP_PAGE_SIZE - 1)
+#define MEMMAP_PAGES      (0x2000 >> MEMMAP_PAGE_SHIFT)
+#define MEMMAP_PAGE(x)    ((x) >> MEMMAP_PAGE_SHIFT)
+
+typedef void (*memmap_read_t)(uint16_t address, uint8_t *data);
+typedef void (*memmap_write_t)(uint16_t address, uint8_t data);
+
+typedef struct {
+    const uint8_t *read_memory;  /* Backing memory for reads, if directly mapped */
+    uint8_t *write_memory;       /* Backing memory for writes, if directly mapped */
+    memmap_read_t read;          /* Device handler for reads otherwise */
+    memmap_write_t write;        /* Device handler for writes otherwise */
+    uint16_t device_offset;      /* Subtracted to give the device's own address */
+} memmap_page_t;
+
+static memmap_page_t page_table[MEMMAP_PAGES] = {0};
+
+/* The last value driven onto the data bus. Reads which no device responds
+ * to return it unchanged.
+ */
+static uint8_t open_bus = 0;
+
+static void memmap_read_TIA(uint16_t address, uint8_t *data)
+{
+#ifdef ATOMIC_INSTRUCTIONS
+    /* The TIA and RIOT are only kept up to date with the CPU when needed */
+    raster_catch_up();
+#endif
+    /* The TIA only decodes the lower four address lines on reads, so its
+     * registers repeat throughout the page
+     */
+    TIA_read_register(address & 0x0F, data);
+}
+
+static void memmap_write_TIA(uint16_t address, uint8_t data)
+{
+#ifdef ATOMIC_INSTRUCTIONS
+    raster_catch_up();
+#endif
+    /* Writes decode the lower six */
+    TIA_write_register(address & 0x3F, data);
+    /* The TIA holds the CPU's RDY line low until the end of the line */
+    if (TIA_get_WSYNC()) {
+        mos6507_set_RDY(0);
+    }
+}
+
+#ifdef SKIP_IDLE_LOOPS
+/* Longest idle loop skipped in one go, in iterations. Keeps the cycles
+ * skipped within range of the CPU's run cycle counter.
+ */
+#define IDLE_LOOP_MAX_ITERATIONS 4096
+
+/* Recognises the instruction reading INTIM as the head of a loop which
+ * does nothing but poll the timer, i.e.:
+ *
+ *     loop: LDA INTIM  (or LDX, LDY, BIT)
+ *           BNE loop   (or any branch on the flags the load sets)
+ *
+ * and skips straight to the final iteration, where the branch falls
+ * through. The CPU is stalled for the cycles skipped, so the TIA and RIOT
+ * still see every one of them. The final iteration
+ * is run for real and overwrites the registers, flags and data bus with
+ * exactly the values stepping through the loop would have left.
+ *
+ * value: value just read from INTIM
+ */
+static void memmap_skip_idle_loop(uint8_t value)
+{
+    const decoded_instruction_t *load, *branch;
+    mos6532_timer_t predicted;
+    uint16_t address, target;
+    uint8_t opcode, condition, a = 0;
+    uint32_t period, iterations;
+
+    /* The load must be an absolute read immediately followed by a branch
+     * back to it, both from the cartridge.
+     */
+    opcode_get_decoded(&load, &address);
+    if (!load || load->instruction->mode != ADDRESSING_ABSOLUTE) {
+        return;
+    }
+    opcode = (uint8_t)(load->instruction - instruction_table);
+    if (opcode != 0xAD && opcode != 0xAE && opcode != 0xAC && opcode != 0x2C) {
+        return;
+    }
+    branch = decode_cache_lookup(address + 3);
+    if (!branch || branch->instruction->mode != ADDRESSING_RELATIVE) {
+        return;
+    }
+    target = (address + 5 + (int8_t)branch->operand[0]) & 0x1FFF;
+    if (target != (address & 0x1FFF)) {
+        return;
+    }
+
+    /* Bits 7-6 of a branch op-code select the flag tested, bit 5 the
+     * value it branches on. Loads leave carry and overflow alone, so
+     * only BIT makes branching on overflow depend on the timer.
+     */
+    condition = (uint8_t)(branch->instruction - instruction_table);
+    if ((condition >> 6) == 2 || ((condition >> 6) == 1 && opcode != 0x2C)) {
+        return;
+    }
+    if (opcode == 0x2C) {
+        mos6507_get_register(MOS6507_REG_A, &a);
+    }
+
+    mos6532_get_timer(&predicted);
+
+    /* Load, taken branch and a cycle more if the branch crosses a page */
+    period = 4 + 3 + ((((address + 5) ^ address) & 0xFF00) ? 1 : 0);
+
+    /* Count the further iterations which would loop back again */
+    for (iterations = 0; iterations < IDLE_LOOP_MAX_ITERATIONS; iterations++) {
+        switch (condition >> 6) {
+            case 0: /* BPL, BMI */
+                if (((value >> 7) & 1) != ((condition >> 5) & 1)) {
+                    goto done;
+                }
+                break;
+            case 1: /* BVC, BVS */
+                if (((value >> 6) & 1) != ((condition >> 5) & 1)) {
+                    goto done;
+                }
+                break;
+            case 3: /* BNE, BEQ */
+                if (((opcode == 0x2C ? (a & value) : value) == 0) != ((condition >> 5) & 1)) {
+                    goto done;
+                }
+                break;
+        }
+        mos6532_timer_advance(&predicted, period);
+        value = predicted.counter;
+    }
+done:
+    if (iterations > 1) {
+        memmap_fast_forward((iterations - 1) * period);
+    }
+}
+
+/* Skips the CPU ahead by a number of clock cycles in which it has no
+ * visible effect, e.g., iterations of an idle loop. The TIA and RIOT carry
+ * on being clocked through them, which costs the RIOT next to nothing as
+ * its timer is only evaluated when read.
+ *
+ * cycles: number of CPU clock cycles to skip
+ */
+void memmap_fast_forward(uint32_t cycles)
+{
+    mos6507_stall(cycles);
+}
+#endif /* SKIP_IDLE_LOOPS */
+
+static void memmap_read_RIOT(uint16_t address, uint8_t *data)
+{
+#ifdef ATOMIC_INSTRUCTIONS
+    raster_catch_up();
+#endif
+    mos6532_read(address, data);
+#ifdef SKIP_IDLE_LOOPS
+    if (address == MOS6532_MEMMAP_INTIM) {
+        memmap_skip_idle_loop(*data);
+    }
+#endif
+}
+
+static void memmap_write_RIOT(uint16_t address, uint8_t data)
+{
+#ifdef ATOMIC_INSTRUCTIONS
+    raster_catch_up();
+#endif
+    mos6532_write(address, data);
+}
+
+static void memmap_map_memory(uint16_t start, const uint8_t *read_memory, uint8_t *write_memory)
+{
+    memmap_page_t *page = &page_table[MEMMAP_PAGE(start)];
+    *page = (memmap_page_t){0};
+    page->read_memory = read_memory;
+    page->write_memory = write_memory;
+}
+
+static void memmap_map_device(uint16_t start, memmap_read_t read, memmap_write_t write, uint16_t device_offset)
+{
+    memmap_page_t *page = &page_table[MEMMAP_PAGE(start)];
+    *page = (memmap_page_t){0};
+    page->read = read;
+    page->write = write;
+    page->device_offset = device_offset;
+}
+
+/* Builds the page table for the TIA and RIOT. Cartridge pages are mapped
+ * separately as a cartridge is loaded.
+ */
+void memmap_init(void)
+{
+    uint8_t *ram = mos6532_get_memory();
+    int i;
+
+    for (i=0; i<MEMMAP_PAGES; i++) {
+        page_table[i] = (memmap_page_t){0};
+    }
+    memmap_map_device(MEMMAP_TIA_START, memmap_read_TIA, memmap_write_TIA, MEMMAP_TIA_START);
+    memmap_map_memory(MEMMAP_RIOT_RAM_START, ram, ram);
+    memmap_map_memory(MEMMAP_RIOT_RAM_MIRROR_START, ram, ram);
+    /* Peripheral registers occupy the lower part of their pages, the RIOT
+     * ignores accesses to the remainder.
+     */
+    memmap_map_device(MEMMAP_RIOT_PERIPH_START, memmap_read_RIOT, memmap_write_RIOT, 0);
+    memmap_map_device(MEMMAP_RIOT_PERIPH_MIRROR_START, memmap_read_RIOT, memmap_write_RIOT,
+                      MEMMAP_RIOT_PERIPH_MIRROR_START - MEMMAP_RIOT_PERIPH_START);
+}
+
+/* Points the cartridge pages at the ROM image, or unmaps them if NULL.
+ * Cartridges are read-only. Are there hardware peripherals which use this
+ * space for extending functionality? E.g., SuperCharger?
+ */
+void memmap_map_cartridge(const uint8_t *cart)
+{
+    uint16_t address;
+
+    for (address=MEMMAP_CART_START; address<=MEMMAP_CART_END; address+=MEMMAP_PAGE_SIZE) {
+        memmap_map_memory(address, cart ? &cart[address - MEMMAP_CART_START] : 0, 0);
+    }
+}
 
 void memmap_map_address(uint16_t *address)
 {
@@ -37,44 +271,111 @@ void memmap_map_address(uint16_t *address)
 /* These read/write functions essentially replicate the 
  * chip-select pins on the TIA and RIOT by delegating 
  * memory access requests to their respective locations.
+ *
+ * The address and data are passed directly rather than through the CPU's
+ * bus latches, which are only updated when tracing the emulator state.
  */
-void memmap_write(void)
+void memmap_bus_write(uint16_t address, uint8_t data)
 {
-    /* Fetch data and address from CPU */
-    uint16_t address, address_offset;
-    uint8_t data;
-    mos6507_get_data_bus(&data);
-    mos6507_get_address_bus(&address);
-    memmap_map_address(&address);
+    const memmap_page_t *page;
+
+#ifdef PRINT_STATE
+    mos6507_set_address_bus(address);
+    mos6507_set_data_bus(data);
+#endif
+    open_bus = data;
+    address &= 0x1FFF;
 
     /* Access particular device */
-    if (IS_TIA(address)) TIA_write_register(address - MEMMAP_TIA_START, data);
-    if (IS_RIOT(address)) {
-        memmap_map_riot_address(&address);
-        mos6532_write(address, data);
-    }
-    if (IS_CART(address)) {
-        /* Cartridges are read-only. Are there hardware peripherals which 
-         * use this space for extending functionality? E.g., SuperCharger?
-         */
+    page = &page_table[MEMMAP_PAGE(address)];
+    if (page->write_memory) {
+        page->write_memory[address & MEMMAP_PAGE_MASK] = data;
+    } else if (page->write) {
+        page->write(address - page->device_offset, data);
     }
 }
 
-void memmap_read(uint8_t *data)
+/* Records a read of the instruction stream which was answered from the
+ * decode cache rather than the cartridge, so the data bus is left holding
+ * the byte as it would have been after the fetch.
+ */
+void memmap_bus_fetched(uint16_t address, uint8_t data)
 {
-    /* Fetch address from CPU */
-    uint16_t address;
-    mos6507_get_address_bus(&address);
-    memmap_map_address(&address);
+#ifdef PRINT_STATE
+    mos6507_set_address_bus(address);
+    mos6507_set_data_bus(data);
+#endif
+    open_bus = data;
+}
+
+uint8_t memmap_bus_read(uint16_t address)
+{
+    const memmap_page_t *page;
+
+#ifdef PRINT_STATE
+    mos6507_set_address_bus(address);
+#endif
+    address &= 0x1FFF;
 
     /* Access particular device */
-    if (IS_TIA(address)) TIA_read_register(address - MEMMAP_TIA_START, data);
-    if (IS_RIOT(address)) {
-        memmap_map_riot_address(&address);
-        mos6532_read(address, data);
+    page = &page_table[MEMMAP_PAGE(address)];
+    if (page->read_memory) {
+        open_bus = page->read_memory[address & MEMMAP_PAGE_MASK];
+    } else if (page->read) {
+        page->read(address - page->device_offset, &open_bus);
     }
-    if (IS_CART(address)) cartridge_read(address - MEMMAP_CART_START, data);
 
+#ifdef PRINT_STATE
+    mos6507_set_data_bus(open_bus);
+#endif
+    return open_bus;
+}
+
+/* Returns 1 if the address is decoded to a device (TIA, RIOT I/O) rather
+ * than plain memory, so accessing it may have side effects.
+ */
+int memmap_is_device(uint16_t address)
+{
+    const memmap_page_t *page = &page_table[MEMMAP_PAGE(address & 0x1FFF)];
+    return (page->read || page->write) ? 1 : 0;
+}
+
+#ifdef DYNAREC
+/* Returns the memory directly backing reads of an address, or NULL if it
+ * is decoded to a device or unmapped, so code generated at run time can
+ * read it without going through the memory map.
+ */
+const uint8_t * memmap_get_read_memory(uint16_t address)
+{
+    const memmap_page_t *page = &page_table[MEMMAP_PAGE(address & 0x1FFF)];
+    return page->read_memory ? &page->read_memory[address & MEMMAP_PAGE_MASK] : 0;
+}
+
+/* As memmap_get_read_memory(), for writes */
+uint8_t * memmap_get_write_memory(uint16_t address)
+{
+    const memmap_page_t *page = &page_table[MEMMAP_PAGE(address & 0x1FFF)];
+    return page->write_memory ? &page->write_memory[address & MEMMAP_PAGE_MASK] : 0;
+}
+#endif /* DYNAREC */
+
+/* Performs an access using the address and data currently latched on the
+ * CPU's busses, for use by the debugger and tests.
+ */
+void memmap_write(void)
+{
+    uint16_t address;
+    uint8_t data;
+    mos6507_get_data_bus(&data);
+    mos6507_get_address_bus(&address);
+    memmap_bus_write(address, data);
+}
+
+void memmap_read(uint8_t *data)
+{
+    uint16_t address;
+    mos6507_get_address_bus(&address);
+    *data = memmap_bus_read(address);
     mos6507_set_data_bus(*data);
 }
 
@@ -24,6 +24,19 @@
 #define MEMMAP_CART_START               0x1000
 #define MEMMAP_CART_END                 0x1FFF
 
+void memmap_init(void);
+void memmap_map_cartridge(const uint8_t *cart);
+void memmap_bus_write(uint16_t address, uint8_t data);
+uint8_t memmap_bus_read(uint16_t address);
+void memmap_bus_fetched(uint16_t address, uint8_t data);
+int memmap_is_device(uint16_t address);
+#ifdef SKIP_IDLE_LOOPS
+void memmap_fast_forward(uint32_t cycles);
+#endif
+#ifdef DYNAREC
+const uint8_t * memmap_get_read_memory(uint16_t address);
+uint8_t * memmap_get_write_memory(uint16_t address);
+#endif
 void memmap_write(void);
 void memmap_read(uint8_t *data);
 void memmap_map_address(uint16_t *address);
@@ -0,0 +1,9 @@
+#ifndef _TEST_COLLISIONS_H
+#define _TEST_COLLISIONS_H
+
+#include <stdint.h>
+
+extern uint8_t test_collisions[4096];
+extern int test_collisions_len;
+
+#endif // _TEST_COLLISIONS_H
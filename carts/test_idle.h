@@ -0,0 +1,9 @@
+#ifndef _TEST_IDLE_H
+#define _TEST_IDLE_H
+
+#include <stdint.h>
+
+extern uint8_t test_idle[4096];
+extern int test_idle_len;
+
+#endif // _TEST_IDLE_H
@@ -0,0 +1,9 @@
+#ifndef _TEST_MIDLINE_H
+#define _TEST_MIDLINE_H
+
+#include <stdint.h>
+
+extern uint8_t test_midline[4096];
+extern int test_midline_len;
+
+#endif // _TEST_MIDLINE_H
@@ -0,0 +1,9 @@
+#ifndef _TEST_PLAYERS_H
+#define _TEST_PLAYERS_H
+
+#include <stdint.h>
+
+extern uint8_t test_players[4096];
+extern int test_players_len;
+
+#endif // _TEST_PLAYERS_H
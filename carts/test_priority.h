@@ -0,0 +1,9 @@
+#ifndef _TEST_PRIORITY_H
+#define _TEST_PRIORITY_H
+
+#include <stdint.h>
+
+extern uint8_t test_priority[4096];
+extern int test_priority_len;
+
+#endif // _TEST_PRIORITY_H
@@ -12,6 +12,7 @@
 #include "mos6507/mos6507.h"
 #include "mos6532/mos6532.h"
 #include "atari/Atari-TIA.h"
+#ifndef HOST_BUILD
 #include "spi.h"
 
 /******************************************************************************
@@ -111,7 +112,192 @@ void colour_test()
 
 }
 #endif /* COLOUR_TEST */
+#endif /* HOST_BUILD */
 
+/******************************************************************************
+ * Emulation
+ *****************************************************************************/
+
+#ifdef EVENT_SCHEDULER
+#ifndef ATOMIC_INSTRUCTIONS
+    #error "EVENT_SCHEDULER requires ATOMIC_INSTRUCTIONS"
+#endif
+#endif
+
+#ifdef ATOMIC_INSTRUCTIONS
+/* An instruction is only run atomically if all of its cycles are certain
+ * to fall within the current line: six more CPU cycles after the first,
+ * three colour clocks apart, plus one for the TIA wrapping its counter.
+ * Instructions are run in batches for as long as this holds.
+ */
+#define ATOMIC_MARGIN (((OPCODE_MAX_CYCLES - 1) * 3) + 1)
+
+static int line_clock = 0;      /* Colour clocks emulated so far this line */
+static int cycles_elapsed = 0;  /* CPU cycles of the current batch clocked through */
+static int cycles_owed = 0;     /* CPU cycles already executed but not yet clocked through */
+static int atomic = 0;          /* Set while a batch of instructions is executed in one call */
+
+#ifdef EVENT_SCHEDULER
+/* The TIA and RIOT are advanced straight to the next event which needs the
+ * CPU's attention rather than one colour clock at a time. Events are:
+ *
+ * - the next CPU cycle, found arithmetically from the TIA's colour clock
+ *   (every third clock from the second, unless halted by WSYNC)
+ * - the TIA wrapping to a new line, which releases WSYNC
+ * - the end of the line being rastered
+ *
+ * The end of horizontal blank is handled within TIA_advance(). The RIOT
+ * timer's underflow needs no event of its own, as the timer is only
+ * evaluated when read.
+ */
+#define RASTER_NO_LIMIT 0x7FFFFFFF
+
+/* Advances the TIA and RIOT until a number of CPU cycles have passed,
+ * stopping just after the last of them, or the line reaches a given
+ * colour clock, whichever comes first.
+ *
+ * cycles: CPU cycles to advance by
+ * limit: line colour clock to stop at regardless
+ *
+ * Returns the number of CPU cycles which passed.
+ */
+static int raster_advance(int cycles, int limit)
+{
+    int colour_clock, clocks, slots, first, passed = 0;
+
+    while (cycles && line_clock < limit) {
+        colour_clock = TIA_get_colour_clock();
+        slots = 0;
+        if (colour_clock >= TIA_COLOUR_CLOCK_TOTAL) {
+            /* The TIA's wrap to a new line takes a clock of its own */
+            clocks = 1;
+        } else if (TIA_get_WSYNC()) {
+            /* Halted until the wrap */
+            clocks = TIA_COLOUR_CLOCK_TOTAL - colour_clock;
+        } else {
+            /* CPU cycles fall on clocks 1, 4, 7 ... 226 of the TIA's line */
+            first = colour_clock + ((4 - (colour_clock % 3)) % 3);
+            if (first > TIA_COLOUR_CLOCK_TOTAL - 2) {
+                clocks = TIA_COLOUR_CLOCK_TOTAL - colour_clock;
+            } else {
+                slots = ((TIA_COLOUR_CLOCK_TOTAL - 2 - first) / 3) + 1;
+                if (slots > cycles) {
+                    slots = cycles;
+                }
+                clocks = first + (3 * (slots - 1)) + 1 - colour_clock;
+            }
+        }
+        if (clocks > limit - line_clock) {
+            clocks = limit - line_clock;
+            if (slots) {
+                slots = ((colour_clock + clocks + 1) / 3) - ((colour_clock + 1) / 3);
+            }
+        }
+        TIA_advance(clocks);
+        if (slots) {
+            mos6532_clock_ticks(slots);
+        }
+        line_clock += clocks;
+        cycles -= slots;
+        passed += slots;
+    }
+    return passed;
+}
+#else
+/* Advances the TIA by one colour clock and, on those clocks where the CPU
+ * would be stepped, the RIOT too.
+ *
+ * Returns 1 if this colour clock is a CPU cycle, 0 otherwise.
+ */
+static int raster_clock(void)
+{
+    int clock_count = TIA_clock_tick();
+    line_clock++;
+    if (!TIA_get_WSYNC() && !((clock_count+1) % 3)) {
+        mos6532_clock_tick();
+        return 1;
+    }
+    return 0;
+}
+#endif /* EVENT_SCHEDULER */
+
+/* Invoked before the CPU accesses the TIA or RIOT part way through an
+ * atomically executed batch of instructions. Brings both up to the colour
+ * clock at which the access would have happened had the CPU been clocked
+ * one cycle at a time.
+ */
+void raster_catch_up(void)
+{
+    uint16_t cycle;
+    if (!atomic) {
+        /* Single stepping, already at the correct colour clock */
+        return;
+    }
+    mos6507_get_run_cycle(&cycle);
+#ifdef EVENT_SCHEDULER
+    if (cycles_elapsed < cycle) {
+        cycles_elapsed += raster_advance(cycle - cycles_elapsed, RASTER_NO_LIMIT);
+    }
+#else
+    while (cycles_elapsed < cycle) {
+        cycles_elapsed += raster_clock();
+    }
+#endif
+}
+
+int raster_line()
+{
+    static int stepping = 0;
+    int cycles;
+    uint8_t cycle;
+
+    line_clock = 0;
+    while (line_clock < TIA_COLOUR_CLOCK_TOTAL) {
+#ifdef EVENT_SCHEDULER
+        /* Skip over the cycles already executed, then on to the next */
+        if (cycles_owed) {
+            cycles_owed -= raster_advance(cycles_owed, TIA_COLOUR_CLOCK_TOTAL);
+            continue;
+        }
+        if (!raster_advance(1, TIA_COLOUR_CLOCK_TOTAL)) {
+            continue;
+        }
+#else
+        if (!raster_clock()) {
+            continue;
+        }
+        if (cycles_owed) {
+            cycles_owed--;
+            continue;
+        }
+#endif
+        /* Fall back to single cycle steps where the instruction may
+         * straddle the end of the line, until it has completed.
+         */
+        if (stepping || (TIA_COLOUR_CLOCK_TOTAL - line_clock) < ATOMIC_MARGIN) {
+            if (mos6507_clock_tick()) {
+                return -1;
+            }
+            mos6507_get_current_instruction_cycle(&cycle);
+            stepping = cycle ? 1 : 0;
+            continue;
+        }
+        /* Run as many instructions as are certain to complete within
+         * the line in one batch. The CPU halts early on WSYNC.
+         */
+        cycles_elapsed = 0;
+        atomic = 1;
+        mos6507_set_RDY(1);
+        cycles = mos6507_run(((TIA_COLOUR_CLOCK_TOTAL - line_clock - ATOMIC_MARGIN) / 3) + 1);
+        atomic = 0;
+        if (cycles < 0) {
+            return -1;
+        }
+        cycles_owed = cycles - 1 - cycles_elapsed;
+    }
+    return 0;
+}
+#else
 int raster_line()
 {
     int i, clock_count;
@@ -126,4 +312,4 @@ int raster_line()
     }
     return 0;
 }
-
+#endif /* ATOMIC_INSTRUCTIONS */
@@ -12,10 +12,12 @@
 /* Standard includes */
 #include <stdint.h>
 
+#ifndef HOST_BUILD
 /* HiFive1/FE310 includes */
 #include "encoding.h"
 #include "platform.h"
 #include "plic/plic_driver.h"
+#endif /* HOST_BUILD */
 
 /* Calculation assumes a core frequency of ~262MHz and pwmscale of 1.
  * Integer value is a result of:
@@ -58,6 +60,7 @@
 #define ATARI_RESOLUTION_WIDTH  160
 #define ATARI_RESOLUTION_HEIGHT 192
 
+#ifndef HOST_BUILD
 void init_clock();
 void init_timer();
 void init_GPIO();
@@ -66,6 +69,10 @@ void enable_interrupts();
 #ifdef COLOUR_TEST
 void colour_test();
 #endif /* COLOUR_TEST*/
+#endif /* HOST_BUILD */
 int raster_line();
+#ifdef ATOMIC_INSTRUCTIONS
+void raster_catch_up(void);
+#endif /* ATOMIC_INSTRUCTIONS */
 
 #endif /* _PLATFORM_UTIL_H */
@@ -0,0 +1,77 @@
+/*
+ * File: host_carts.c
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Cartridges built into the host tools, selected by name. These are the
+ * kernels and test cartridges in carts/ covered by the regression checks
+ * ("make -C host check"), each translated by rom2c for -DAOT_CODE builds.
+ */
+
+#include <string.h>
+#include "host_carts.h"
+/* Game cart data */
+#include "carts/kernel_01.h"
+#include "carts/kernel_11.h"
+#include "carts/kernel_13.h"
+#include "carts/kernel_15.h"
+#include "carts/kernel_21.h"
+#include "carts/kernel_22.h"
+#include "carts/test_idle.h"
+#include "carts/test_midline.h"
+#include "carts/test_collisions.h"
+#include "carts/test_priority.h"
+#include "carts/test_players.h"
+#ifdef AOT_CODE
+    #include "carts/kernel_01_aot.h"
+    #include "carts/kernel_11_aot.h"
+    #include "carts/kernel_13_aot.h"
+    #include "carts/kernel_15_aot.h"
+    #include "carts/kernel_21_aot.h"
+    #include "carts/kernel_22_aot.h"
+    #include "carts/test_idle_aot.h"
+    #include "carts/test_midline_aot.h"
+    #include "carts/test_collisions_aot.h"
+    #include "carts/test_priority_aot.h"
+    #include "carts/test_players_aot.h"
+#endif
+
+#ifdef AOT_CODE
+    #define HOST_CART(_name) { #_name, _name, &_name##_aot }
+#else
+    #define HOST_CART(_name) { #_name, _name }
+#endif
+
+static const host_cart_t carts[] = {
+    HOST_CART(kernel_01),
+    HOST_CART(kernel_11),
+    HOST_CART(kernel_13),
+    HOST_CART(kernel_15),
+    HOST_CART(kernel_21),
+    HOST_CART(kernel_22),
+    HOST_CART(test_idle),
+    HOST_CART(test_midline),
+    HOST_CART(test_collisions),
+    HOST_CART(test_priority),
+    HOST_CART(test_players)
+};
+
+#define HOST_CARTS (sizeof(carts) / sizeof(carts[0]))
+
+/* Finds a built-in cartridge.
+ *
+ * name: name of the cartridge's image, e.g., "kernel_22"
+ *
+ * Returns NULL if there is no such cartridge.
+ */
+const host_cart_t * host_carts_find(const char *name)
+{
+    size_t i;
+
+    for (i=0; i<HOST_CARTS; i++) {
+        if (!strcmp(name, carts[i].name)) {
+            return &carts[i];
+        }
+    }
+    return 0;
+}
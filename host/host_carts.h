@@ -0,0 +1,27 @@
+/*
+ * File: host_carts.h
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Cartridges built into the host tools, selected by name.
+ */
+
+#ifndef _HOST_CARTS_H
+#define _HOST_CARTS_H
+
+#include <stdint.h>
+#ifdef AOT_CODE
+    #include "mos6507/mos6507-aot.h"
+#endif
+
+typedef struct {
+    const char *name;
+    uint8_t *image;
+#ifdef AOT_CODE
+    const aot_index_t *translation;  /* Generated by rom2c */
+#endif
+} host_cart_t;
+
+const host_cart_t * host_carts_find(const char *name);
+
+#endif /* _HOST_CARTS_H */
@@ -0,0 +1,18 @@
+/*
+ * File: host_display.h
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Stands in for the ILI9341 driver when building for a Linux host.
+ */
+
+#ifndef _HOST_DISPLAY_H
+#define _HOST_DISPLAY_H
+
+#include <stdint.h>
+
+void host_display_reset(void);
+uint32_t host_display_get_checksum(void);
+uint32_t host_display_get_lines_drawn(void);
+
+#endif /* _HOST_DISPLAY_H */
@@ -0,0 +1,198 @@
+/* See LICENSE file for license details */
+
+/*
+ * File: main.c
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Headless entry point for running the emulator on a Linux host. Loads a
+ * cartridge, runs a fixed number of frames as quickly as the host allows and
+ * reports emulation throughput. Intended for benchmarking changes to the CPU
+ * and TIA models without needing the HiFive1 hardware attached.
+ *
+ * Usage: HiFive1-2600-host [-f frames] [-v] [-c cartridge | rom.bin]
+ *
+ * -v prints the output checksum as each frame completes, so that builds can
+ * be compared frame by frame.
+ *
+ * -c runs one of the cartridges built in from carts/, e.g., test_idle,
+ * rather than the default kernel_22 or a ROM image.
+ *
+ * Built with -DEXEC_TESTS ("make -C host tests") it runs the CPU unit tests
+ * in test/tests.c instead.
+ */
+
+/* Standard library includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Atari and platform includes */
+#include "mos6507/mos6507.h"
+#include "atari/Atari-TIA.h"
+#include "atari/Atari-cart.h"
+#include "atari/Atari-memmap.h"
+#include "mos6532/mos6532.h"
+#include "external/platform_util.h"
+#include "host_display.h"
+#include "host_carts.h"
+#ifdef EXEC_TESTS
+    #include "test/tests.h"
+#endif
+
+#define CART_SIZE      (MEMMAP_CART_END - MEMMAP_CART_START + 1)
+#define DEFAULT_FRAMES 600
+
+/* If a cartridge never strobes VSYNC the run would otherwise never complete,
+ * so consider a frame finished after this many lines regardless.
+ */
+#define MAX_FRAME_LINES (TIA_VERTICAL_TOTAL_LINES * 2)
+
+static uint8_t rom_image[CART_SIZE];
+
+/* Reads a binary ROM dump into the cartridge buffer. 2K images are mirrored
+ * across the full 4K window as the real hardware would see them.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+static int load_rom_file(const char *path)
+{
+    FILE *rom;
+    size_t length;
+
+    rom = fopen(path, "rb");
+    if (!rom) {
+        perror(path);
+        return -1;
+    }
+    length = fread(rom_image, 1, CART_SIZE, rom);
+    fclose(rom);
+
+    if (length == CART_SIZE / 2) {
+        memcpy(&rom_image[CART_SIZE / 2], rom_image, CART_SIZE / 2);
+    } else if (length != CART_SIZE) {
+        fprintf(stderr, "%s: unsupported ROM size (%zu bytes)\n", path, length);
+        return -1;
+    }
+    return 0;
+}
+
+static double elapsed_seconds(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) +
+           (end->tv_nsec - start->tv_nsec) / 1000000000.0;
+}
+
+int main(int argc, char *argv[])
+{
+    int i;
+    long frames = DEFAULT_FRAMES;
+    const char *rom_path = NULL;
+    const host_cart_t *cart = host_carts_find("kernel_22");
+    struct timespec start, end;
+    double seconds;
+    uint32_t vblank = 0;
+    uint32_t vsync = 0;
+    uint32_t line_count = 0;
+    uint32_t frame_lines = 0;
+    uint64_t total_lines = 0;
+    long frame_count = 0;
+    int verbose = 0;
+#ifdef SCANLINE_CACHE
+    uint32_t cache_hits, cache_misses;
+#endif
+
+    for (i=1; i<argc; i++) {
+        if (!strcmp(argv[i], "-f") && (i+1 < argc)) {
+            frames = strtol(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-v")) {
+            verbose = 1;
+        } else if (!strcmp(argv[i], "-c") && (i+1 < argc)) {
+            cart = host_carts_find(argv[++i]);
+            if (!cart) {
+                fprintf(stderr, "%s: no such built-in cartridge\n", argv[i]);
+                return 1;
+            }
+        } else {
+            rom_path = argv[i];
+        }
+    }
+
+    /* Setup and reset all the emulated
+     * hardware: memory, CPU, TIA etc ...
+     */
+    mos6532_init();
+    TIA_init();
+    memmap_init();
+
+#ifdef EXEC_TESTS
+    execute_tests();
+    return 0;
+#endif /* EXEC_TESTS */
+
+    if (rom_path) {
+        if (load_rom_file(rom_path)) {
+            return 1;
+        }
+        cartridge_load(rom_image);
+    } else {
+        cartridge_load(cart->image);
+#ifdef AOT_CODE
+        aot_load(cart->translation);
+#endif
+    }
+    mos6507_reset();
+    host_display_reset();
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (frame_count < frames) {
+        if (raster_line()) {
+            fprintf(stderr, "Error in emulation encountered after %ld frames\n", frame_count);
+            return 1;
+        }
+        total_lines++;
+        frame_lines++;
+        if (vsync && !TIA_get_VSYNC()) {
+            line_count = 0;
+            vblank = TIA_VERTICAL_BLANK_LINES;
+            frame_lines = 0;
+            frame_count++;
+            if (verbose) {
+                printf("Frame %ld: 0x%08X\n", frame_count, host_display_get_checksum());
+            }
+        } else if (frame_lines >= MAX_FRAME_LINES) {
+            frame_lines = 0;
+            frame_count++;
+            if (verbose) {
+                printf("Frame %ld: 0x%08X\n", frame_count, host_display_get_checksum());
+            }
+        }
+        vsync = TIA_get_VSYNC();
+        if (!vsync && !vblank && (line_count < TIA_VERTICAL_PICTURE_LINES)) {
+            TIA_draw_line(line_count);
+            TIA_reset_buffer();
+            line_count++;
+        }
+        if (vblank) {
+            vblank--;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    seconds = elapsed_seconds(&start, &end);
+    printf("Frames:             %ld\n", frame_count);
+    printf("Scanlines:          %llu\n", (unsigned long long)total_lines);
+    printf("Elapsed:            %.3f s\n", seconds);
+    printf("Frames/sec:         %.1f\n", frame_count / seconds);
+    printf("Colour clocks/sec:  %.0f\n", (total_lines * TIA_COLOUR_CLOCK_TOTAL) / seconds);
+    printf("Output checksum:    0x%08X (%u lines)\n",
+           host_display_get_checksum(), host_display_get_lines_drawn());
+#ifdef SCANLINE_CACHE
+    TIA_get_scanline_cache_stats(&cache_hits, &cache_misses);
+    printf("Scanline cache:     %u hits, %u misses (%.1f%%)\n", cache_hits, cache_misses,
+           (cache_hits + cache_misses) ? (100.0 * cache_hits) / (cache_hits + cache_misses) : 0.0);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,495 @@
+/* See LICENSE file for license details */
+
+/*
+ * File: rom2c.c
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Translates a cartridge image to C ahead of time, for building into the
+ * firmware with -DAOT_CODE.
+ *
+ * Code is traced from the reset and interrupt vectors, following branches,
+ * jumps and subroutine calls to build the control flow graph. Wherever
+ * execution may arrive (the target of a branch or jump, the instruction
+ * after a branch or call, or after an instruction left to the interpreter)
+ * a block is started, running until an instruction which accesses the TIA
+ * or RIOT or changes the flow of control. Each block is emitted as a C
+ * function, calling the operations of its instructions (see
+ * mos6507-opcodes.h) directly, along with its worst case cycle cost.
+ * Returns from subroutines and interrupts, indirect jumps and anything
+ * only reached through them are left to the interpreter, and bytes never
+ * reached are assumed to be data.
+ *
+ * Usage: rom2c [-o prefix] [-c cartridge | rom.bin]
+ *
+ * Writes <prefix>_aot.c and <prefix>_aot.h, declaring <name>_aot where
+ * name is the last component of the prefix. -c translates one of the
+ * cartridges built into the host tools (see host_carts.c), by default
+ * kernel_22 to ../carts/kernel_22.
+ */
+
+/* Standard library includes */
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Atari and platform includes */
+#include "mos6507/mos6507-opcodes.h"
+#include "atari/Atari-memmap.h"
+#include "atari/Atari-TIA.h"
+#include "mos6532/mos6532.h"
+#include "test/debug.h"
+/* Game cart data */
+#include "host_carts.h"
+
+#define CART_SIZE (MEMMAP_CART_END - MEMMAP_CART_START + 1)
+
+/* Blocks are only entered when they fit within the remainder of the
+ * line, so longer ones would rarely get to run.
+ */
+#define ROM2C_MAX_CYCLES 48
+
+#define ROM2C_RESET_VECTOR 0x0FFC
+#define ROM2C_IRQ_VECTOR   0x0FFE
+
+/* Op-codes needing special treatment when tracing */
+#define OPCODE_BRK      0x00
+#define OPCODE_JSR      0x20
+#define OPCODE_RTI      0x40
+#define OPCODE_JMP      0x4C
+#define OPCODE_RTS      0x60
+#define OPCODE_JMP_IND  0x6C
+
+/* Properties of each byte of the cartridge */
+#define ROM2C_OPCODE  0x01  /* First byte of a traced instruction */
+#define ROM2C_OPERAND 0x02  /* Operand of a traced instruction */
+#define ROM2C_LEADER  0x04  /* Execution may arrive here other than by falling through */
+
+static uint8_t rom_image[CART_SIZE];
+static uint8_t properties[CART_SIZE];
+static uint16_t worklist[CART_SIZE];
+static int worklist_length = 0;
+static int unresolved = 0;
+
+/* Reads a binary ROM dump, mirroring 2K images as the hardware would.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+static int load_rom_file(const char *path)
+{
+    FILE *rom;
+    size_t length;
+
+    rom = fopen(path, "rb");
+    if (!rom) {
+        perror(path);
+        return -1;
+    }
+    length = fread(rom_image, 1, CART_SIZE, rom);
+    fclose(rom);
+
+    if (length == CART_SIZE / 2) {
+        memcpy(&rom_image[CART_SIZE / 2], rom_image, CART_SIZE / 2);
+    } else if (length != CART_SIZE) {
+        fprintf(stderr, "%s: unsupported ROM size (%zu bytes)\n", path, length);
+        return -1;
+    }
+    return 0;
+}
+
+/* Converts a CPU address to an offset into the cartridge.
+ *
+ * Returns -1 if the address lies outside the cartridge.
+ */
+static int cart_offset(uint16_t address)
+{
+    address &= 0x1FFF;
+    if (address < MEMMAP_CART_START) {
+        return -1;
+    }
+    return address - MEMMAP_CART_START;
+}
+
+static uint16_t read_word(int offset)
+{
+    return rom_image[offset] | (rom_image[(offset + 1) % CART_SIZE] << 8);
+}
+
+/* Marks a location execution may arrive at and queues it for tracing */
+static void add_leader(int offset)
+{
+    if (offset < 0 || offset >= CART_SIZE) {
+        return;
+    }
+    if (!(properties[offset] & ROM2C_LEADER)) {
+        properties[offset] |= ROM2C_LEADER;
+        worklist[worklist_length++] = offset;
+    }
+}
+
+/* Returns 1 if an instruction can't disturb the TIA or RIOT, as for the
+ * threaded code translator.
+ */
+static int is_pure(const instruction_t *instruction, int offset)
+{
+    switch (instruction->mode) {
+        case ADDRESSING_IMPLIED:
+        case ADDRESSING_IMMEDIATE:
+        case ADDRESSING_RELATIVE:
+            return 1;
+        case ADDRESSING_ZERO_PAGE:
+            return !memmap_is_device(rom_image[offset + 1]);
+        case ADDRESSING_ABSOLUTE:
+            return !memmap_is_device(read_word(offset + 1));
+        default:
+            return 0;
+    }
+}
+
+/* Follows the flow of control from a leader until it leaves the
+ * straight line code.
+ */
+static void trace(int offset)
+{
+    const instruction_t *instruction;
+    uint8_t opcode;
+    int i;
+
+    while (offset < CART_SIZE && !(properties[offset] & ROM2C_OPCODE)) {
+        opcode = rom_image[offset];
+        instruction = &instruction_table[opcode];
+        if (!instruction->steps[0] || offset + instruction->length > CART_SIZE) {
+            /* Most likely data, the interpreter will report it if run */
+            unresolved++;
+            return;
+        }
+        properties[offset] |= ROM2C_OPCODE;
+        for (i=1; i<instruction->length; i++) {
+            properties[offset + i] |= ROM2C_OPERAND;
+        }
+
+        switch (opcode) {
+            case OPCODE_JMP:
+                add_leader(cart_offset(read_word(offset + 1)));
+                return;
+            case OPCODE_JSR:
+                add_leader(cart_offset(read_word(offset + 1)));
+                add_leader(offset + instruction->length);
+                return;
+            case OPCODE_JMP_IND:
+            case OPCODE_RTS:
+            case OPCODE_RTI:
+            case OPCODE_BRK:
+                unresolved++;
+                return;
+            default:
+                break;
+        }
+        if (ADDRESSING_RELATIVE == instruction->mode) {
+            add_leader(offset + 2 + (int8_t)rom_image[offset + 1]);
+            add_leader(offset + 2);
+            return;
+        }
+        offset += instruction->length;
+        if (!is_pure(instruction, offset - instruction->length)) {
+            /* The interpreter hands back here */
+            add_leader(offset);
+            return;
+        }
+    }
+}
+
+/* Counts the instructions of the block starting at a leader, and its
+ * cost were every branch and page crossing taken.
+ */
+static int measure_block(int offset, int *cycles)
+{
+    const instruction_t *instruction;
+    int length = 0;
+    int block_cycles, i;
+
+    *cycles = 0;
+    while (offset < CART_SIZE && (properties[offset] & ROM2C_OPCODE)) {
+        instruction = &instruction_table[rom_image[offset]];
+        if (!is_pure(instruction, offset)) {
+            break;
+        }
+        block_cycles = 0;
+        for (i=0; i<OPCODE_MAX_CYCLES && instruction->steps[i]; i++) {
+            block_cycles++;
+        }
+        if (*cycles + block_cycles > ROM2C_MAX_CYCLES) {
+            /* Continue with a new block */
+            add_leader(offset);
+            break;
+        }
+        *cycles += block_cycles;
+        length++;
+        if (ADDRESSING_RELATIVE == instruction->mode) {
+            break;
+        }
+        offset += instruction->length;
+    }
+    return length;
+}
+
+/* Names the operation an instruction performs, e.g., op_LDA, from its
+ * mnemonic. Shifts of the accumulator have operations of their own.
+ */
+static void operation_name(uint8_t opcode, char *name, size_t length)
+{
+    const char *description = debug_lookup_opcode_str(opcode);
+    int written;
+
+    if (!strcmp(description, "Unknown")) {
+        fprintf(stderr, "No operation name for op-code 0x%02X\n", opcode);
+        exit(1);
+    }
+    written = snprintf(name, length, "op_%.3s%s", description,
+                       strstr(description, "Accumulator") ? "_A" : "");
+    if (written < 0 || (size_t)written >= length) {
+        fprintf(stderr, "Operation name of op-code 0x%02X is too long\n", opcode);
+        exit(1);
+    }
+}
+
+/* Returns the clock cycles taken by an instruction's steps, including
+ * those only run when a branch is taken or a page is crossed.
+ */
+static int step_count(const instruction_t *instruction)
+{
+    int i;
+
+    for (i=0; i<OPCODE_MAX_CYCLES && instruction->steps[i]; i++) {
+        /* Count the remaining steps */
+    }
+    return i;
+}
+
+/* Emits a block as a C function which performs each instruction's
+ * operation on its operand, read from or written to an address fixed at
+ * build time. The program counter is only updated on leaving the block,
+ * relative to where it was entered as the cartridge may be run from any
+ * of its mirrors.
+ */
+static void emit_block(FILE *out, int offset, int length)
+{
+    const instruction_t *instruction;
+    char operation[16];
+    uint8_t opcode, operand;
+    uint16_t address;
+    int i, start, cycles = 0;
+
+    fprintf(out, "static int block_%04X(void)\n", MEMMAP_CART_START + offset);
+    fprintf(out, "{\n");
+    fprintf(out, "    uint16_t PC = mos6507_get_PC();\n");
+    fprintf(out, "    uint8_t data;\n\n");
+
+    for (i=0, start=offset; i<length; i++) {
+        opcode = rom_image[start];
+        operand = rom_image[start + 1];
+        address = read_word(start + 1);
+        instruction = &instruction_table[opcode];
+        operation_name(opcode, operation, sizeof(operation));
+        fprintf(out, "    /* 0x%04X: %s */\n", MEMMAP_CART_START + start, debug_lookup_opcode_str(opcode));
+
+        switch (instruction->mode) {
+            case ADDRESSING_IMPLIED:
+                if (i == length - 1) {
+                    /* Leave the last fetch on the data bus */
+                    fprintf(out, "    memmap_bus_fetched(PC + %d, 0x%02X);\n", start - offset, opcode);
+                }
+                fprintf(out, "    %s(&data);\n", operation);
+                break;
+            case ADDRESSING_IMMEDIATE:
+                if (i == length - 1) {
+                    fprintf(out, "    memmap_bus_fetched(PC + %d, 0x%02X);\n", start - offset + 1, operand);
+                }
+                fprintf(out, "    data = 0x%02X;\n", operand);
+                fprintf(out, "    %s(&data);\n", operation);
+                break;
+            case ADDRESSING_RELATIVE:
+                /* Always last, not taken takes the base cycles, taken adds
+                 * one more and another for landing on a different page
+                 */
+                address = start + 2 + (int8_t)operand;
+                fprintf(out, "    memmap_bus_fetched(PC + %d, 0x%02X);\n", start - offset + 1, operand);
+                fprintf(out, "    %s(&data);\n", operation);
+                fprintf(out, "    if (data) {\n");
+                fprintf(out, "        mos6507_set_PC(PC %c %d);\n",
+                        address < offset ? '-' : '+', abs(address - offset));
+                fprintf(out, "        return %d;\n",
+                        cycles + instruction->cycles + 1 + (((start + 2) ^ address) & 0xFF00 ? 1 : 0));
+                fprintf(out, "    }\n");
+                break;
+            default:
+                if (instruction->mode == ADDRESSING_ZERO_PAGE) {
+                    address = operand;
+                }
+                if (!strcmp(operation, "op_STA") || !strcmp(operation, "op_STX") || !strcmp(operation, "op_STY")) {
+                    fprintf(out, "    %s(&data);\n", operation);
+                    fprintf(out, "    memmap_bus_write(0x%04X, data);\n", address);
+                } else if (!strcmp(operation, "op_INC") || !strcmp(operation, "op_DEC") ||
+                           !strcmp(operation, "op_ASL") || !strcmp(operation, "op_LSR") ||
+                           !strcmp(operation, "op_ROL") || !strcmp(operation, "op_ROR")) {
+                    fprintf(out, "    data = memmap_bus_read(0x%04X);\n", address);
+                    fprintf(out, "    %s(&data);\n", operation);
+                    fprintf(out, "    memmap_bus_write(0x%04X, data);\n", address);
+                } else {
+                    fprintf(out, "    data = memmap_bus_read(0x%04X);\n", address);
+                    fprintf(out, "    %s(&data);\n", operation);
+                }
+                break;
+        }
+        cycles += (ADDRESSING_RELATIVE == instruction->mode) ? instruction->cycles : step_count(instruction);
+        start += instruction->length;
+    }
+
+    fprintf(out, "    mos6507_set_PC(PC + %d);\n", start - offset);
+    fprintf(out, "    return %d;\n", cycles);
+    fprintf(out, "}\n");
+}
+
+static void emit_source(FILE *out, const char *name)
+{
+    int offset, length, cycles, start;
+    int blocks = 0;
+
+    fprintf(out, "/*\n");
+    fprintf(out, " * File: %s_aot.c\n", name);
+    fprintf(out, " *\n");
+    fprintf(out, " * Generated by host/rom2c, do not edit. Translation of %s for\n", name);
+    fprintf(out, " * building with -DAOT_CODE.\n");
+    fprintf(out, " *\n");
+    fprintf(out, " * Unreached, so assumed to be data or only reached indirectly:\n");
+    for (offset=0; offset<CART_SIZE; offset++) {
+        if (properties[offset] & (ROM2C_OPCODE | ROM2C_OPERAND)) {
+            continue;
+        }
+        start = offset;
+        while (offset + 1 < CART_SIZE && !(properties[offset + 1] & (ROM2C_OPCODE | ROM2C_OPERAND))) {
+            offset++;
+        }
+        fprintf(out, " *   0x%04X-0x%04X\n", MEMMAP_CART_START + start, MEMMAP_CART_START + offset);
+    }
+    fprintf(out, " */\n\n");
+    fprintf(out, "#ifdef AOT_CODE\n\n");
+    fprintf(out, "#include \"atari/Atari-memmap.h\"\n");
+    fprintf(out, "#include \"mos6507/mos6507.h\"\n");
+    fprintf(out, "#include \"%s_aot.h\"\n\n", name);
+
+    for (offset=0; offset<CART_SIZE; offset++) {
+        if (!(properties[offset] & ROM2C_LEADER) || !(properties[offset] & ROM2C_OPCODE)) {
+            continue;
+        }
+        length = measure_block(offset, &cycles);
+        if (length < 2) {
+            /* Would gain nothing over the interpreter */
+            properties[offset] &= ~ROM2C_LEADER;
+            continue;
+        }
+        emit_block(out, offset, length);
+        fprintf(out, "static const aot_block_t aot_%04X = { %d, block_%04X };\n\n",
+                MEMMAP_CART_START + offset, cycles, MEMMAP_CART_START + offset);
+        blocks++;
+    }
+
+    fprintf(out, "aot_index_t %s_aot = {\n", name);
+    for (offset=0; offset<CART_SIZE; offset++) {
+        if ((properties[offset] & ROM2C_LEADER) && (properties[offset] & ROM2C_OPCODE)) {
+            fprintf(out, "    [0x%03X] = &aot_%04X,\n", offset, MEMMAP_CART_START + offset);
+        }
+    }
+    fprintf(out, "};\n\n");
+    fprintf(out, "#endif /* AOT_CODE */\n");
+
+    fprintf(stderr, "%s: %d blocks, %d exits left to the interpreter\n", name, blocks, unresolved);
+}
+
+static void emit_header(FILE *out, const char *name)
+{
+    char guard[FILENAME_MAX];
+    int i;
+
+    for (i=0; name[i] && i<FILENAME_MAX-1; i++) {
+        guard[i] = toupper((unsigned char)name[i]);
+    }
+    guard[i] = 0;
+
+    fprintf(out, "/*\n");
+    fprintf(out, " * File: %s_aot.h\n", name);
+    fprintf(out, " *\n");
+    fprintf(out, " * Generated by host/rom2c, do not edit.\n");
+    fprintf(out, " */\n\n");
+    fprintf(out, "#ifndef _%s_AOT_H\n", guard);
+    fprintf(out, "#define _%s_AOT_H\n\n", guard);
+    fprintf(out, "#include \"mos6507/mos6507-aot.h\"\n\n");
+    fprintf(out, "extern aot_index_t %s_aot;\n\n", name);
+    fprintf(out, "#endif /* _%s_AOT_H */\n", guard);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *prefix = "../carts/kernel_22";
+    const char *rom_path = NULL;
+    const host_cart_t *cart = host_carts_find("kernel_22");
+    const char *name;
+    char path[FILENAME_MAX];
+    FILE *out;
+    int i;
+
+    for (i=1; i<argc; i++) {
+        if (!strcmp(argv[i], "-o") && (i+1 < argc)) {
+            prefix = argv[++i];
+        } else if (!strcmp(argv[i], "-c") && (i+1 < argc)) {
+            cart = host_carts_find(argv[++i]);
+            if (!cart) {
+                fprintf(stderr, "%s: no such built-in cartridge\n", argv[i]);
+                return 1;
+            }
+        } else {
+            rom_path = argv[i];
+        }
+    }
+    name = strrchr(prefix, '/') ? strrchr(prefix, '/') + 1 : prefix;
+
+    if (rom_path) {
+        if (load_rom_file(rom_path)) {
+            return 1;
+        }
+    } else {
+        memcpy(rom_image, cart->image, CART_SIZE);
+    }
+
+    /* Only the TIA and RIOT are needed, to know which addresses they occupy */
+    mos6532_init();
+    TIA_init();
+    memmap_init();
+
+    add_leader(cart_offset(read_word(ROM2C_RESET_VECTOR)));
+    add_leader(cart_offset(read_word(ROM2C_IRQ_VECTOR)));
+    while (worklist_length) {
+        trace(worklist[--worklist_length]);
+    }
+
+    snprintf(path, sizeof(path), "%s_aot.c", prefix);
+    out = fopen(path, "w");
+    if (!out) {
+        perror(path);
+        return 1;
+    }
+    emit_source(out, name);
+    fclose(out);
+
+    snprintf(path, sizeof(path), "%s_aot.h", prefix);
+    out = fopen(path, "w");
+    if (!out) {
+        perror(path);
+        return 1;
+    }
+    emit_header(out, name);
+    fclose(out);
+
+    return 0;
+}
@@ -19,6 +19,7 @@
 #include "mos6507/mos6507.h"
 #include "atari/Atari-TIA.h"
 #include "atari/Atari-cart.h"
+#include "atari/Atari-memmap.h"
 #include "mos6532/mos6532.h"
 #ifdef EXEC_TESTS
     #include "test/test-carts.h"
@@ -29,6 +30,9 @@
 #endif
 /* Game cart data */
 #include "carts/kernel_22.h"
+#ifdef AOT_CODE
+    #include "carts/kernel_22_aot.h"
+#endif
 
 /* Globals */
 static const char atari_logo[] = "\n\r"
@@ -89,12 +93,15 @@ int main()
     /* Setup and reset all the emulated
      * hardware: memory, CPU, TIA etc ...
      */
-    opcode_populate_ISA_table();
     mos6532_init();
     TIA_init();
+    memmap_init();
 
     /* Emulation is ready to start so load cartridge and reset CPU */
     cartridge_load(kernel_22);
+#ifdef AOT_CODE
+    aot_load(&kernel_22_aot);
+#endif
     mos6507_reset();
 
     /* Setup FE310 peripherals */
@@ -3,560 +3,282 @@
  */
 #define NOT_SAME_PAGE(_addr1, _addr2) (((_addr1) ^ (_addr2)) & 0xFF00)
 
-#define CALC_BRANCH() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&offset); \
-            if (!condition) { \
-                END_OPCODE() \
-                return 0; \
-            } \
-            return -1; \
-        case 2: \
-            mos6507_increment_PC(); \
-            if (offset & 0x80) { \
-                compliment = ~(offset & 0x7F); \
-                compliment++; \
-                addr = mos6507_get_PC() - (compliment & 0x7F); \
-            } else { \
-                addr = mos6507_get_PC() + (offset & 0x7F); \
-            } \
-            if (NOT_SAME_PAGE(mos6507_get_PC(), addr)) { \
-                return -1; \
-            } \
-            mos6507_set_PC(addr); \
-            mos6507_set_address_bus(addr); \
-            return 0; \
-        case 3: \
-            mos6507_set_PC(addr); \
-        default: \
-            break; \
-    } \
+/*
+ * Steps which invoke an operation are written once, taking the operation
+ * as an argument, and specialised for each operation at compile time. The
+ * table then points at a step with the operation already bound, which the
+ * compiler is free to inline, rather than passing it along at run time.
+ */
+#define SPECIALISED(_step, _op) _step##__##_op
+
+#define SPECIALISE(_step, _op) \
+    static inline int SPECIALISED(_step, _op)(void) { return _step(_op); }
+
+#define SPECIALISE_IMPLIED(_op) \
+    SPECIALISE(step_implied, _op)
+
+#define SPECIALISE_RELATIVE(_op) \
+    SPECIALISE(step_branch_offset, _op)
+
+#define SPECIALISE_READ(_op) \
+    SPECIALISE(step_read_immediate, _op) \
+    SPECIALISE(step_read_zero_page, _op) \
+    SPECIALISE(step_read_zero_page_x, _op) \
+    SPECIALISE(step_read_zero_page_y, _op) \
+    SPECIALISE(step_read_absolute, _op) \
+    SPECIALISE(step_read_absolute_x, _op) \
+    SPECIALISE(step_read_absolute_y, _op)
+
+#define SPECIALISE_WRITE(_op) \
+    SPECIALISE(step_write_zero_page, _op) \
+    SPECIALISE(step_write_zero_page_x, _op) \
+    SPECIALISE(step_write_zero_page_y, _op) \
+    SPECIALISE(step_write_absolute, _op) \
+    SPECIALISE(step_write_absolute_x, _op) \
+    SPECIALISE(step_write_absolute_y, _op)
+
+#define SPECIALISE_MODIFY(_op) \
+    SPECIALISE(step_modify_zero_page, _op) \
+    SPECIALISE(step_modify_zero_page_x, _op) \
+    SPECIALISE(step_modify_absolute, _op) \
+    SPECIALISE(step_modify_absolute_x, _op)
+
+#define SPECIALISE_PUSH(_op) \
+    SPECIALISE(step_push, _op)
+
+#define SPECIALISE_PULL(_op) \
+    SPECIALISE(step_pull, _op)
 
 /*
+ * Each macro below expands to an instruction_table entry for one
+ * addressing mode: the instruction length in bytes, its base cycle count,
+ * the addressing mode and the step run on each clock cycle. Cycle 0 always consumes the
+ * op-code fetch. Steps which may finish the instruction early (e.g., no
+ * page boundary crossed) are followed by the steps for the remaining
+ * cycles.
  */
-#define FETCH_STORE_ADDRESS_ABSOLUTE() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&adl); \
-            return -1; \
-        case 2: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&adh); \
-            return -1; \
-        case 3: \
-            mos6507_set_address_bus_hl(adh, adl); \
-        default: \
-            break; \
+
+/* Instructions which take no operand from memory */
+#define IMPLIED(_op) { 1, 2, ADDRESSING_IMPLIED, { \
+        step_fetch_opcode, \
+        SPECIALISED(step_implied, _op) \
     } \
+}
 
-#define FETCH_STORE_ADDRESS_IMMEDIATE() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-        default: \
-            break; \
+/* Conditional branches. The operation reports the branch condition */
+#define RELATIVE(_op) { 2, 2, ADDRESSING_RELATIVE, { \
+        step_fetch_opcode, \
+        SPECIALISED(step_branch_offset, _op), \
+        step_branch_target, \
+        step_branch_page_cross \
     } \
+}
 
-#define FETCH_STORE_ADDRESS_ZERO_PAGE() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&adl); \
-            return -1; \
-        case 2: \
-            mos6507_set_address_bus_hl(0, adl); \
-        default: \
-            break; \
+/*
+ * These macros apply when reading from a memory location prior
+ * to perfroming an operation where the result is placed into,
+ * or occurs, entirely within the CPU (e.g., compare a value to
+ * the accumulator, or an index register etc.).
+ */
+#define READ_IMMEDIATE(_op) { 2, 2, ADDRESSING_IMMEDIATE, { \
+        step_fetch_opcode, \
+        SPECIALISED(step_read_immediate, _op) \
     } \
+}
 
-#define FETCH_STORE_ADDRESS_ABSOLUTE() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&adl); \
-            return -1; \
-        case 2: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&adh); \
-            return -1; \
-        case 3: \
-            mos6507_set_address_bus_hl(adh, adl); \
-        default: \
-            break; \
+#define READ_ZERO_PAGE(_op) { 2, 3, ADDRESSING_ZERO_PAGE, { \
+        step_fetch_opcode, \
+        step_fetch_adl, \
+        SPECIALISED(step_read_zero_page, _op) \
     } \
+}
 
-#define FETCH_STORE_ADDRESS_INDIRECT_X_INDEXED() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bal); \
-            return -1; \
-        case 2: \
-            mos6507_set_address_bus_hl(0, bal); \
-            return -1; \
-        case 3: \
-            mos6507_get_register(MOS6507_REG_X, &X); \
-            mos6507_set_address_bus_hl(0, (bal + X)); \
-            memmap_read(&adl); \
-            return -1; \
-        case 4: \
-            mos6507_get_register(MOS6507_REG_X, &X); \
-            mos6507_set_address_bus_hl(0, ((bal + X) + 1)); \
-            memmap_read(&adh); \
-            return -1; \
-        case 5: \
-            mos6507_set_address_bus_hl(adh, adl); \
-        default: \
-            break; \
+#define READ_ZERO_PAGE_X_INDEXED(_op) { 2, 4, ADDRESSING_ZERO_PAGE_INDEXED, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_zero_page_base, \
+        SPECIALISED(step_read_zero_page_x, _op) \
     } \
+}
 
-#define FETCH_STORE_ADDRESS_ABSOLUTE_X_INDEXED() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bal); \
-            return -1; \
-        case 2: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bah); \
-            return -1; \
-        case 3: \
-            mos6507_get_register(MOS6507_REG_X, &X); \
-            adl = bal + X; \
-            if ((bal + X) & 0x0100) { \
-                c = 1; \
-            } \
-            adh = bah + c; \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-            if (c) { \
-                return -1; \
-            } \
-            break; \
-        case 4: \
-            mos6507_get_register(MOS6507_REG_X, &X); \
-            adl = bal + X; \
-            if ((bal + X) & 0x0100) { \
-                c = 1; \
-            } \
-            adh = bah + c; \
-            mos6507_set_address_bus_hl(adh, adl); \
-        default: \
-            break; \
+#define READ_ZERO_PAGE_Y_INDEXED(_op) { 2, 4, ADDRESSING_ZERO_PAGE_INDEXED, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_zero_page_base, \
+        SPECIALISED(step_read_zero_page_y, _op) \
     } \
+}
 
-#define FETCH_STORE_ADDRESS_ABSOLUTE_Y_INDEXED() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bal); \
-            return -1; \
-        case 2: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bah); \
-            return -1; \
-        case 3: \
-            mos6507_get_register(MOS6507_REG_Y, &Y); \
-            adl = bal + Y; \
-            if ((bal + Y) & 0x0100) { \
-                c = 1; \
-            } \
-            adh = bah + c; \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-            if (c) { \
-                return -1; \
-            } \
-            break; \
-        case 4: \
-            mos6507_get_register(MOS6507_REG_Y, &Y); \
-            adl = bal + Y; \
-            if ((bal + Y) & 0x0100) { \
-                c = 1; \
-            } \
-            adh = bah + c; \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-        default: \
-            break; \
+#define READ_ABSOLUTE(_op) { 3, 4, ADDRESSING_ABSOLUTE, { \
+        step_fetch_opcode, \
+        step_fetch_adl, \
+        step_fetch_adh, \
+        SPECIALISED(step_read_absolute, _op) \
     } \
+}
 
-#define FETCH_STORE_ADDRESS_ZERO_PAGE_X_INDEXED() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bal); \
-            return -1; \
-        case 2: \
-            mos6507_set_address_bus_hl(0, bal); \
-            return -1; \
-        case 3: \
-            mos6507_get_register(MOS6507_REG_X, &X); \
-            mos6507_set_address_bus_hl(0, bal + X); \
-        default: \
-            break; \
+#define READ_ABSOLUTE_X_INDEXED(_op) { 3, 4, ADDRESSING_ABSOLUTE_INDEXED, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_fetch_bah, \
+        SPECIALISED(step_read_absolute_x, _op), \
+        SPECIALISED(step_read_absolute, _op) \
     } \
+}
 
-#define FETCH_STORE_ADDRESS_ZERO_PAGE_Y_INDEXED() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bal); \
-            return -1; \
-        case 2: \
-            mos6507_set_address_bus_hl(0, bal); \
-            return -1; \
-        case 3: \
-            mos6507_get_register(MOS6507_REG_Y, &Y); \
-            mos6507_set_address_bus_hl(0, bal + Y); \
-        default: \
-            break; \
+#define READ_ABSOLUTE_Y_INDEXED(_op) { 3, 4, ADDRESSING_ABSOLUTE_INDEXED, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_fetch_bah, \
+        SPECIALISED(step_read_absolute_y, _op), \
+        SPECIALISED(step_read_absolute, _op) \
     } \
+}
 
+#define READ_INDIRECT_X_INDEXED(_op) { 2, 6, ADDRESSING_INDIRECT, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_zero_page_base, \
+        step_fetch_indirect_adl, \
+        step_fetch_indirect_adh, \
+        SPECIALISED(step_read_absolute, _op) \
+    } \
+}
 
+#define READ_INDIRECT_Y_INDEXED(_op) { 2, 5, ADDRESSING_INDIRECT, { \
+        step_fetch_opcode, \
+        step_fetch_ial, \
+        step_fetch_indirect_bal, \
+        step_fetch_indirect_bah, \
+        SPECIALISED(step_read_absolute_y, _op), \
+        SPECIALISED(step_read_absolute, _op) \
+    } \
+}
 
 /*
- * These macros apply when reading from a memory location prior
- * to perfroming an operation where the result is placed into, 
- * or occurs, entirely within the CPU (e.g., compare a value to 
- * the accumulator, or an index register etc.).
+ * These macros apply when the operation supplies a value from
+ * within the CPU to be stored at the resolved address.
  */
-#define FETCH_DATA_ABSOLUTE() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&adl); \
-            return -1; \
-        case 2: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&adh); \
-            return -1; \
-        case 3: \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-        default: \
-            break; \
+#define WRITE_ZERO_PAGE(_op) { 2, 3, ADDRESSING_ZERO_PAGE, { \
+        step_fetch_opcode, \
+        step_fetch_adl, \
+        SPECIALISED(step_write_zero_page, _op) \
     } \
+}
 
-#define FETCH_DATA_IMMEDIATE() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&data); \
-        default: \
-            break; \
+#define WRITE_ZERO_PAGE_X_INDEXED(_op) { 2, 4, ADDRESSING_ZERO_PAGE_INDEXED, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_zero_page_base, \
+        SPECIALISED(step_write_zero_page_x, _op) \
     } \
+}
 
-#define FETCH_DATA_ZERO_PAGE() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&adl); \
-            return -1; \
-        case 2: \
-            mos6507_set_address_bus_hl(0, adl); \
-            memmap_read(&data); \
-        default: \
-            break; \
+#define WRITE_ZERO_PAGE_Y_INDEXED(_op) { 2, 4, ADDRESSING_ZERO_PAGE_INDEXED, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_zero_page_base, \
+        SPECIALISED(step_write_zero_page_y, _op) \
     } \
+}
 
-#define FETCH_DATA_ABSOLUTE() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&adl); \
-            return -1; \
-        case 2: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&adh); \
-            return -1; \
-        case 3: \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-        default: \
-            break; \
+#define WRITE_ABSOLUTE(_op) { 3, 4, ADDRESSING_ABSOLUTE, { \
+        step_fetch_opcode, \
+        step_fetch_adl, \
+        step_fetch_adh, \
+        SPECIALISED(step_write_absolute, _op) \
     } \
+}
 
-#define FETCH_DATA_INDIRECT_X_INDEXED() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bal); \
-            return -1; \
-        case 2: \
-            mos6507_set_address_bus_hl(0, bal); \
-            return -1; \
-        case 3: \
-            mos6507_get_register(MOS6507_REG_X, &X); \
-            mos6507_set_address_bus_hl(0, (bal + X)); \
-            memmap_read(&adl); \
-            return -1; \
-        case 4: \
-            mos6507_get_register(MOS6507_REG_X, &X); \
-            mos6507_set_address_bus_hl(0, ((bal + X) + 1)); \
-            memmap_read(&adh); \
-            return -1; \
-        case 5: \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-        default: \
-            break; \
+#define WRITE_ABSOLUTE_X_INDEXED(_op) { 3, 4, ADDRESSING_ABSOLUTE_INDEXED, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_fetch_bah, \
+        SPECIALISED(step_write_absolute_x, _op), \
+        SPECIALISED(step_write_absolute, _op) \
     } \
+}
 
-#define FETCH_DATA_INDIRECT_Y_INDEXED() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&ial); \
-            return -1; \
-        case 2: \
-            mos6507_set_address_bus_hl(0, ial); \
-            memmap_read(&bal); \
-            return -1; \
-        case 3: \
-            mos6507_set_address_bus_hl(0, ial+1); \
-            memmap_read(&bah); \
-            return -1; \
-        case 4: \
-            mos6507_get_register(MOS6507_REG_Y, &Y); \
-            adl = bal + Y; \
-            if ((bal + Y) & 0x0100) { \
-                c = 1; \
-            } \
-            adh = bah + c; \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-            if (c) { \
-                return -1; \
-            } \
-            break; \
-        case 5: \
-            mos6507_get_register(MOS6507_REG_Y, &Y); \
-            adl = bal + Y; \
-            if ((bal + Y) & 0x0100) { \
-                c = 1; \
-            } \
-            adh = bah + c; \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-        default: \
-            break; \
+#define WRITE_ABSOLUTE_Y_INDEXED(_op) { 3, 4, ADDRESSING_ABSOLUTE_INDEXED, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_fetch_bah, \
+        SPECIALISED(step_write_absolute_y, _op), \
+        SPECIALISED(step_write_absolute, _op) \
     } \
+}
 
-#define FETCH_DATA_ABSOLUTE_X_INDEXED() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bal); \
-            return -1; \
-        case 2: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bah); \
-            return -1; \
-        case 3: \
-            mos6507_get_register(MOS6507_REG_X, &X); \
-            adl = bal + X; \
-            if ((bal + X) & 0x0100) { \
-                c = 1; \
-            } \
-            adh = bah + c; \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-            if (c) { \
-                return -1; \
-            } \
-            break; \
-        case 4: \
-            mos6507_get_register(MOS6507_REG_X, &X); \
-            adl = bal + X; \
-            if ((bal + X) & 0x0100) { \
-                c = 1; \
-            } \
-            adh = bah + c; \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-        default: \
-            break; \
+#define WRITE_INDIRECT_X_INDEXED(_op) { 2, 6, ADDRESSING_INDIRECT, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_zero_page_base, \
+        step_fetch_indirect_adl, \
+        step_fetch_indirect_adh, \
+        SPECIALISED(step_write_absolute, _op) \
     } \
+}
 
-#define FETCH_DATA_ABSOLUTE_Y_INDEXED() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bal); \
-            return -1; \
-        case 2: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bah); \
-            return -1; \
-        case 3: \
-            mos6507_get_register(MOS6507_REG_Y, &Y); \
-            adl = bal + Y; \
-            if ((bal + Y) & 0x0100) { \
-                c = 1; \
-            } \
-            adh = bah + c; \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-            if (c) { \
-                return -1; \
-            } \
-            break; \
-        case 4: \
-            mos6507_get_register(MOS6507_REG_Y, &Y); \
-            adl = bal + Y; \
-            if ((bal + Y) & 0x0100) { \
-                c = 1; \
-            } \
-            adh = bah + c; \
-            mos6507_set_address_bus_hl(adh, adl); \
-            memmap_read(&data); \
-        default: \
-            break; \
+#define WRITE_INDIRECT_Y_INDEXED(_op) { 2, 5, ADDRESSING_INDIRECT, { \
+        step_fetch_opcode, \
+        step_fetch_ial, \
+        step_fetch_indirect_bal, \
+        step_fetch_indirect_bah, \
+        SPECIALISED(step_write_absolute_y, _op), \
+        SPECIALISED(step_write_absolute, _op) \
     } \
+}
 
-#define FETCH_DATA_ZERO_PAGE_X_INDEXED() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bal); \
-            return -1; \
-        case 2: \
-            mos6507_set_address_bus_hl(0, bal); \
-            return -1; \
-        case 3: \
-            mos6507_get_register(MOS6507_REG_X, &X); \
-            mos6507_set_address_bus_hl(0, bal + X); \
-            memmap_read(&data); \
-        default: \
-            break; \
+/*
+ * These macros apply when a value is read from memory, operated
+ * upon and written back to the same location (e.g., INC, ROL).
+ */
+#define MODIFY_ZERO_PAGE(_op) { 2, 3, ADDRESSING_ZERO_PAGE, { \
+        step_fetch_opcode, \
+        step_fetch_adl, \
+        SPECIALISED(step_modify_zero_page, _op) \
+    } \
+}
+
+#define MODIFY_ZERO_PAGE_X_INDEXED(_op) { 2, 4, ADDRESSING_ZERO_PAGE_INDEXED, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_zero_page_base, \
+        SPECIALISED(step_modify_zero_page_x, _op) \
     } \
+}
 
-#define FETCH_DATA_ZERO_PAGE_Y_INDEXED() \
-    switch(cycle) { \
-        case 0: \
-            return -1; \
-        case 1: \
-            mos6507_increment_PC(); \
-            mos6507_set_address_bus(mos6507_get_PC()); \
-            memmap_read(&bal); \
-            return -1; \
-        case 2: \
-            mos6507_set_address_bus_hl(0, bal); \
-            return -1; \
-        case 3: \
-            mos6507_get_register(MOS6507_REG_Y, &Y); \
-            mos6507_set_address_bus_hl(0, bal + Y); \
-            memmap_read(&data); \
-        default: \
-            break; \
+#define MODIFY_ABSOLUTE(_op) { 3, 4, ADDRESSING_ABSOLUTE, { \
+        step_fetch_opcode, \
+        step_fetch_adl, \
+        step_fetch_adh, \
+        SPECIALISED(step_modify_absolute, _op) \
     } \
+}
 
-#define FETCH_DATA() \
-    if (OPCODE_ADDRESSING_MODE_IMMEDIATE == address_mode) { \
-        FETCH_DATA_IMMEDIATE() \
-    } else if (OPCODE_ADDRESSING_MODE_ZERO_PAGE == address_mode) { \
-        FETCH_DATA_ZERO_PAGE() \
-    } else if (OPCODE_ADDRESSING_MODE_ABSOLUTE == address_mode) { \
-        FETCH_DATA_ABSOLUTE() \
-    } else if (OPCODE_ADDRESSING_MODE_INDIRECT_X_INDEXED == address_mode) { \
-        FETCH_DATA_INDIRECT_X_INDEXED() \
-    } else if (OPCODE_ADDRESSING_MODE_INDIRECT_Y_INDEXED == address_mode) { \
-        FETCH_DATA_INDIRECT_Y_INDEXED() \
-    } else if (OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED == address_mode) { \
-        FETCH_DATA_ABSOLUTE_X_INDEXED() \
-    } else if (OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED == address_mode) { \
-        FETCH_DATA_ABSOLUTE_Y_INDEXED() \
-    } else if (OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED == address_mode) { \
-        FETCH_DATA_ZERO_PAGE_X_INDEXED() \
-    } else if (OPCODE_ADDRESSING_MODE_ZERO_PAGE_Y_INDEXED == address_mode) { \
-        FETCH_DATA_ZERO_PAGE_Y_INDEXED() \
+#define MODIFY_ABSOLUTE_X_INDEXED(_op) { 3, 4, ADDRESSING_ABSOLUTE_INDEXED, { \
+        step_fetch_opcode, \
+        step_fetch_bal, \
+        step_fetch_bah, \
+        SPECIALISED(step_modify_absolute_x, _op), \
+        SPECIALISED(step_modify_absolute, _op) \
     } \
+}
 
-#define FETCH_STORE_ADDRESS() \
-    if (OPCODE_ADDRESSING_MODE_IMMEDIATE == address_mode) { \
-        FETCH_STORE_ADDRESS_IMMEDIATE() \
-    } else if (OPCODE_ADDRESSING_MODE_ZERO_PAGE == address_mode) { \
-        FETCH_STORE_ADDRESS_ZERO_PAGE() \
-    } else if (OPCODE_ADDRESSING_MODE_ABSOLUTE == address_mode) { \
-        FETCH_STORE_ADDRESS_ABSOLUTE() \
-    } else if (OPCODE_ADDRESSING_MODE_INDIRECT_X_INDEXED == address_mode) { \
-        FETCH_STORE_ADDRESS_INDIRECT_X_INDEXED() \
-    } else if (OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED == address_mode) { \
-        FETCH_STORE_ADDRESS_ABSOLUTE_X_INDEXED() \
-    } else if (OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED == address_mode) { \
-        FETCH_STORE_ADDRESS_ABSOLUTE_Y_INDEXED() \
-    } else if (OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED == address_mode) { \
-        FETCH_STORE_ADDRESS_ZERO_PAGE_X_INDEXED() \
-    } else if (OPCODE_ADDRESSING_MODE_ZERO_PAGE_Y_INDEXED == address_mode) { \
-        FETCH_STORE_ADDRESS_ZERO_PAGE_Y_INDEXED() \
+/*
+ * Stack operations. The operation supplies the value to push, or
+ * receives the value pulled.
+ */
+#define PUSH(_op) { 1, 3, ADDRESSING_STACK, { \
+        step_fetch_opcode, \
+        step_increment_PC, \
+        SPECIALISED(step_push, _op) \
     } \
+}
 
+#define PULL(_op) { 1, 4, ADDRESSING_STACK, { \
+        step_fetch_opcode, \
+        step_increment_PC, \
+        step_stack_address, \
+        SPECIALISED(step_pull, _op) \
+    } \
+}
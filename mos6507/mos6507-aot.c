@@ -0,0 +1,53 @@
+/*
+ * File: mos6507-aot.c
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Runs cartridge code translated ahead of time by host/rom2c.
+ *
+ * The translation is compiled into the firmware alongside the cartridge
+ * image. It covers the same kind of blocks as the threaded code
+ * translator, instructions which can't disturb the TIA or RIOT, but found
+ * by tracing the program's control flow at build time. Each block is a C
+ * function calling the instructions' operations with their operands and
+ * addresses already resolved, so nothing is fetched or decoded when it
+ * runs. Code only reached indirectly, or which accesses a device, is left
+ * to the interpreter.
+ */
+
+#ifdef AOT_CODE
+#ifndef ATOMIC_INSTRUCTIONS
+    #error "AOT_CODE requires ATOMIC_INSTRUCTIONS"
+#endif
+
+#include "atari/Atari-memmap.h"
+#include "mos6507-aot.h"
+
+static const aot_index_t *translation = 0;
+
+/* Selects the translation of the cartridge being run.
+ *
+ * index: translation generated for the cartridge, or NULL for none
+ */
+void aot_load(const aot_index_t *index)
+{
+    translation = index;
+}
+
+/* Finds the translated block starting at an address.
+ *
+ * address: location of the first op-code, as held in the program counter
+ *
+ * Returns NULL if no block starts at the address.
+ */
+const aot_block_t * aot_lookup(uint16_t address)
+{
+    /* Match the mirroring applied by the memory map */
+    address &= 0x1FFF;
+    if (!translation || address < MEMMAP_CART_START) {
+        return 0;
+    }
+    return (*translation)[address - MEMMAP_CART_START];
+}
+
+#endif /* AOT_CODE */
@@ -0,0 +1,34 @@
+/*
+ * File: mos6507-aot.h
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Runs cartridge code translated ahead of time by host/rom2c.
+ */
+
+#ifndef _MOS6507_AOT_H
+#define _MOS6507_AOT_H
+
+#include <stdint.h>
+
+#define AOT_INDEX_LENGTH 4096
+
+/* Runs a translated block, leaving the program counter at the instruction
+ * following it. Returns the number of clock cycles consumed.
+ */
+typedef int (*aot_code_t)(void);
+
+typedef struct {
+    uint8_t cycles;  /* Clock cycles taken if every branch and page crossing is taken */
+    aot_code_t code;
+} aot_block_t;
+
+/* Translated blocks indexed by their offset into the cartridge, NULL
+ * where no block starts.
+ */
+typedef const aot_block_t * const aot_index_t[AOT_INDEX_LENGTH];
+
+void aot_load(const aot_index_t *index);
+const aot_block_t * aot_lookup(uint16_t address);
+
+#endif /* _MOS6507_AOT_H */
@@ -0,0 +1,69 @@
+/*
+ * File: mos6507-decode-cache.c
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Caches instructions decoded from cartridge ROM.
+ *
+ * Cartridge ROM can't change underneath the CPU, so once an instruction
+ * has been decoded its op-code and operands can be reused each time the
+ * program counter returns to it (e.g., a kernel's scanline loop) rather
+ * than being fetched byte by byte through the memory map. The cache must
+ * be invalidated whenever a different cartridge is inserted.
+ */
+
+#include "atari/Atari-memmap.h"
+#include "atari/Atari-cart.h"
+#include "mos6507-decode-cache.h"
+
+static decoded_instruction_t decode_cache[DECODE_CACHE_ENTRIES] = {0};
+
+/* Finds the decoded instruction at an address, decoding it on first use.
+ *
+ * address: location of the op-code, as held in the program counter
+ *
+ * Returns NULL if the address lies outside the cartridge, the op-code is
+ * illegal or the operands would run off the end of the cartridge.
+ */
+const decoded_instruction_t * decode_cache_lookup(uint16_t address)
+{
+    decoded_instruction_t *entry;
+    uint8_t opcode = 0;
+    uint16_t offset;
+    int i;
+
+    /* Match the mirroring applied by the memory map */
+    address &= 0x1FFF;
+    if (address < MEMMAP_CART_START) {
+        return 0;
+    }
+
+    entry = &decode_cache[address % DECODE_CACHE_ENTRIES];
+    if (entry->tag == address) {
+        return entry;
+    }
+
+    offset = address - MEMMAP_CART_START;
+    cartridge_read(offset, &opcode);
+    if (!instruction_table[opcode].steps[0]) {
+        return 0;
+    }
+    if (offset + instruction_table[opcode].length > (MEMMAP_CART_END - MEMMAP_CART_START + 1)) {
+        return 0;
+    }
+
+    entry->instruction = &instruction_table[opcode];
+    for (i=1; i<entry->instruction->length; i++) {
+        cartridge_read(offset + i, &entry->operand[i-1]);
+    }
+    entry->tag = address;
+    return entry;
+}
+
+void decode_cache_invalidate(void)
+{
+    int i;
+    for (i=0; i<DECODE_CACHE_ENTRIES; i++) {
+        decode_cache[i].tag = 0;
+    }
+}
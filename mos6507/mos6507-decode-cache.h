@@ -0,0 +1,34 @@
+/*
+ * File: mos6507-decode-cache.h
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Caches instructions decoded from cartridge ROM.
+ */
+
+#ifndef _MOS6507_DECODE_CACHE_H
+#define _MOS6507_DECODE_CACHE_H
+
+#include <stdint.h>
+#include "mos6507-opcodes.h"
+
+/* Entries are direct mapped by address. On the host there is room to
+ * cover the entire 4KB cartridge window, while the FE310 only has 16KB
+ * of RAM in total so a smaller window of the most recent code is kept.
+ */
+#ifdef HOST_BUILD
+    #define DECODE_CACHE_ENTRIES 4096
+#else
+    #define DECODE_CACHE_ENTRIES 256
+#endif
+
+typedef struct decoded_instruction {
+    const instruction_t *instruction; /* Resolved op-code, length and cycle count */
+    uint16_t tag;                     /* Mapped address decoded from, 0 if empty */
+    uint8_t  operand[2];              /* Operand bytes following the op-code */
+} decoded_instruction_t;
+
+const decoded_instruction_t * decode_cache_lookup(uint16_t address);
+void decode_cache_invalidate(void);
+
+#endif /* _MOS6507_DECODE_CACHE_H */
@@ -0,0 +1,768 @@
+/*
+ * File: mos6507-dynarec.c
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Compiles blocks of cartridge code to native x86-64 code.
+ *
+ * Blocks are the same kind the threaded code translator finds: a run of
+ * instructions whose operands are immediate or lie in RAM or ROM, with a
+ * trailing conditional branch included. Each instruction is compiled to
+ * x86-64 working directly on the CPU's registers and lazily evaluated
+ * flags, addressed from rbx, and on the memory backing its operand. Carry
+ * and overflow come straight from the host's own adc, sbb, sub and shift
+ * instructions. Only decimal mode ADC and SBC call back into
+ * mos6507-microcode.c.
+ *
+ * As a block never accesses the TIA or RIOT, it always returns to
+ * mos6507_run(), and its catch-up logic, before an instruction which
+ * might, and it is only entered when its worst case cycle count fits the
+ * budget raster_line() passed in. On leaving, the data bus holds the value
+ * the interpreter would have left on it.
+ *
+ * Code is written to an arena which is writable or executable but never
+ * both at once. It is flushed when full or when a cartridge is loaded or
+ * ejected.
+ *
+ * Only intended for host builds, to speed up batch runs. Compare output
+ * against the interpreter with "make -C host check-dynarec".
+ */
+
+#ifdef DYNAREC
+#ifndef ATOMIC_INSTRUCTIONS
+    #error "DYNAREC requires ATOMIC_INSTRUCTIONS"
+#endif
+#if !defined(__x86_64__) || !defined(HOST_BUILD)
+    #error "DYNAREC requires a host build for x86-64"
+#endif
+
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "atari/Atari-memmap.h"
+#include "mos6507.h"
+#include "mos6507-microcode.h"
+#include "mos6507-decode-cache.h"
+#include "mos6507-dynarec.h"
+
+/* Space reserved for the longest instruction (ADC or SBC from memory,
+ * with its decimal mode call) and for the entry or an exit of a block
+ */
+#define DYNAREC_INSTRUCTION_SIZE 80
+#define DYNAREC_EXIT_SIZE        64
+#define DYNAREC_CODE_SIZE        ((DYNAREC_BLOCK_LENGTH * DYNAREC_INSTRUCTION_SIZE) + (2 * DYNAREC_EXIT_SIZE))
+
+/* Displacement of a CPU register from rbx */
+#define CPU(_field) ((uint8_t)offsetof(mos6507, _field))
+
+/* x86-64 byte registers, as encoded in the reg field of a ModRM byte */
+#define AL 0
+#define CL 1
+#define DL 2
+
+/* x86-64 condition codes, for setcc and jcc */
+#define CC_O  0x0
+#define CC_C  0x2
+#define CC_NC 0x3
+#define CC_Z  0x4
+#define CC_NZ 0x5
+
+static dynarec_block_t blocks[DYNAREC_BLOCKS] = {0};
+static uint8_t *arena = 0;
+static size_t arena_used = 0;
+
+/* Emitters for the handful of x86-64 instructions needed */
+
+static void emit_byte(uint8_t **code, uint8_t byte)
+{
+    *(*code)++ = byte;
+}
+
+static void emit_imm16(uint8_t **code, uint16_t imm)
+{
+    memcpy(*code, &imm, sizeof(imm));
+    *code += sizeof(imm);
+}
+
+static void emit_imm32(uint8_t **code, uint32_t imm)
+{
+    memcpy(*code, &imm, sizeof(imm));
+    *code += sizeof(imm);
+}
+
+static void emit_imm64(uint8_t **code, uint64_t imm)
+{
+    memcpy(*code, &imm, sizeof(imm));
+    *code += sizeof(imm);
+}
+
+/* An instruction with a [rbx+disp8] operand, reg being either a register
+ * or the op-code extension
+ */
+static void emit_rbx(uint8_t **code, uint8_t opcode, uint8_t reg, uint8_t disp)
+{
+    emit_byte(code, opcode);
+    emit_byte(code, 0x43 | (reg << 3));
+    emit_byte(code, disp);
+}
+
+/* mov reg, [rbx+disp] */
+static void emit_load(uint8_t **code, uint8_t reg, uint8_t disp)
+{
+    emit_rbx(code, 0x8A, reg, disp);
+}
+
+/* mov [rbx+disp], reg */
+static void emit_store(uint8_t **code, uint8_t reg, uint8_t disp)
+{
+    emit_rbx(code, 0x88, reg, disp);
+}
+
+/* mov byte [rbx+disp], imm */
+static void emit_store_imm(uint8_t **code, uint8_t disp, uint8_t imm)
+{
+    emit_rbx(code, 0xC6, 0, disp);
+    emit_byte(code, imm);
+}
+
+/* setcc byte [rbx+disp] */
+static void emit_setcc(uint8_t **code, uint8_t cc, uint8_t disp)
+{
+    emit_byte(code, 0x0F);
+    emit_rbx(code, 0x90 | cc, 0, disp);
+}
+
+/* op al, cl, for one of add (0x00), or (0x08), adc (0x10), sbb (0x18),
+ * and (0x20), sub (0x28) or xor (0x30)
+ */
+static void emit_alu(uint8_t **code, uint8_t opcode)
+{
+    emit_byte(code, opcode);
+    emit_byte(code, 0xC8);
+}
+
+/* mov rsi, pointer */
+static void emit_pointer(uint8_t **code, const uint8_t *pointer)
+{
+    emit_byte(code, 0x48);
+    emit_byte(code, 0xBE);
+    emit_imm64(code, (uint64_t)(uintptr_t)pointer);
+}
+
+/* mov rax, function; call rax */
+static void emit_call(uint8_t **code, const void *function)
+{
+    emit_byte(code, 0x48);
+    emit_byte(code, 0xB8);
+    emit_imm64(code, (uint64_t)(uintptr_t)function);
+    emit_byte(code, 0xFF);
+    emit_byte(code, 0xD0);
+}
+
+/* Records reg as the result the negative and zero flags derive from */
+static void emit_set_NZ(uint8_t **code, uint8_t reg)
+{
+    emit_store(code, reg, CPU(N_result));
+    emit_store(code, reg, CPU(Z_result));
+}
+
+/* Loads the 6507's carry into the host's, inverted as a borrow for
+ * subtraction: mov dl, [rbx+C]; (xor dl, 1;) shr dl, 1
+ */
+static void emit_carry_in(uint8_t **code, int borrow)
+{
+    emit_load(code, DL, CPU(C));
+    if (borrow) {
+        emit_byte(code, 0x80);
+        emit_byte(code, 0xF2);
+        emit_byte(code, 0x01);
+    }
+    emit_byte(code, 0xD0);
+    emit_byte(code, 0xEA);
+}
+
+/* Leaves a byte of the instruction stream on the data bus as its fetch
+ * would have, located relative to the program counter at the start of the
+ * block: movzx edi, word [rbx+PC]; add edi, offset; movzx edi, di;
+ * mov esi, data; call memmap_bus_fetched
+ */
+static void emit_bus_fetched(uint8_t **code, uint16_t offset, uint8_t data)
+{
+    emit_byte(code, 0x0F);
+    emit_rbx(code, 0xB7, 7, CPU(PC));
+    emit_byte(code, 0x81);
+    emit_byte(code, 0xC7);
+    emit_imm32(code, offset);
+    emit_byte(code, 0x0F);
+    emit_byte(code, 0xB7);
+    emit_byte(code, 0xFF);
+    emit_byte(code, 0xBE);
+    emit_imm32(code, data);
+    emit_call(code, memmap_bus_fetched);
+}
+
+/* Leaves a byte of memory on the data bus as reading or writing it would
+ * have: mov edi, address; mov rsi, memory; movzx esi, byte [rsi];
+ * call memmap_bus_fetched
+ */
+static void emit_bus_accessed(uint8_t **code, uint16_t address, const uint8_t *memory)
+{
+    emit_byte(code, 0xBF);
+    emit_imm32(code, address);
+    emit_pointer(code, memory);
+    emit_byte(code, 0x0F);
+    emit_byte(code, 0xB6);
+    emit_byte(code, 0x36);
+    emit_call(code, memmap_bus_fetched);
+}
+
+/* Leaves the block, advancing the program counter relative to where it
+ * was entered as the cartridge may be run from any of its mirrors:
+ * add word [rbx+PC], offset; mov eax, cycles; pop rbx; ret
+ */
+static void emit_exit(uint8_t **code, uint16_t offset, uint32_t cycles)
+{
+    emit_byte(code, 0x66);
+    emit_rbx(code, 0x81, 0, CPU(PC));
+    emit_imm16(code, offset);
+    emit_byte(code, 0xB8);
+    emit_imm32(code, cycles);
+    emit_byte(code, 0x5B);
+    emit_byte(code, 0xC3);
+}
+
+/* Operand addressing */
+
+static uint16_t dynarec_operand_address(const decoded_instruction_t *decoded)
+{
+    if (ADDRESSING_ZERO_PAGE == decoded->instruction->mode) {
+        return decoded->operand[0];
+    }
+    return (decoded->operand[1] << 8) | decoded->operand[0];
+}
+
+/* Returns the memory an instruction writes to, or NULL if it isn't RAM */
+static uint8_t * dynarec_write_memory(const decoded_instruction_t *decoded)
+{
+    uint16_t address = dynarec_operand_address(decoded);
+    uint8_t *memory = memmap_get_write_memory(address);
+
+    if (memory != memmap_get_read_memory(address)) {
+        return 0;
+    }
+    return memory;
+}
+
+/* Loads an instruction's operand into cl: mov cl, imm or
+ * mov rsi, memory; mov cl, [rsi]
+ *
+ * Returns 0 if the operand isn't in RAM or ROM.
+ */
+static int emit_operand(uint8_t **code, const decoded_instruction_t *decoded)
+{
+    const uint8_t *memory;
+
+    if (ADDRESSING_IMMEDIATE == decoded->instruction->mode) {
+        emit_byte(code, 0xB1);
+        emit_byte(code, decoded->operand[0]);
+        return 1;
+    }
+    memory = memmap_get_read_memory(dynarec_operand_address(decoded));
+    if (!memory) {
+        return 0;
+    }
+    emit_pointer(code, memory);
+    emit_byte(code, 0x8A);
+    emit_byte(code, 0x0E);
+    return 1;
+}
+
+/* Instructions, each returning 0 if it can't be compiled */
+
+/* LDA, LDX, LDY */
+static int emit_LD(uint8_t **code, const decoded_instruction_t *decoded, uint8_t reg)
+{
+    if (!emit_operand(code, decoded)) {
+        return 0;
+    }
+    emit_store(code, CL, reg);
+    emit_set_NZ(code, CL);
+    return 1;
+}
+
+/* STA, STX, STY: mov al, [rbx+reg]; mov rsi, memory; mov [rsi], al */
+static int emit_ST(uint8_t **code, const decoded_instruction_t *decoded, uint8_t reg)
+{
+    uint8_t *memory = dynarec_write_memory(decoded);
+
+    if (!memory) {
+        return 0;
+    }
+    emit_load(code, AL, reg);
+    emit_pointer(code, memory);
+    emit_byte(code, 0x88);
+    emit_byte(code, 0x06);
+    return 1;
+}
+
+/* AND, ORA, EOR */
+static int emit_logical(uint8_t **code, const decoded_instruction_t *decoded, uint8_t alu)
+{
+    if (!emit_operand(code, decoded)) {
+        return 0;
+    }
+    emit_load(code, AL, CPU(A));
+    emit_alu(code, alu);
+    emit_store(code, AL, CPU(A));
+    emit_set_NZ(code, AL);
+    return 1;
+}
+
+/* ADC, SBC. Binary mode uses the host's adc or sbb, whose carry and
+ * overflow match the 6507's. Decimal mode calls the microcode.
+ */
+static int emit_arithmetic(uint8_t **code, const decoded_instruction_t *decoded, int subtract)
+{
+    uint8_t *decimal, *done;
+
+    if (!emit_operand(code, decoded)) {
+        return 0;
+    }
+    /* test byte [rbx+P], D; jnz decimal */
+    emit_rbx(code, 0xF6, 0, CPU(P));
+    emit_byte(code, MOS6507_STATUS_FLAG_DECIMAL);
+    decimal = *code;
+    emit_byte(code, 0x70 | CC_NZ);
+    emit_byte(code, 0);
+
+    emit_carry_in(code, subtract);
+    emit_load(code, AL, CPU(A));
+    emit_alu(code, subtract ? 0x18 : 0x10);
+    emit_setcc(code, subtract ? CC_NC : CC_C, CPU(C));
+    emit_setcc(code, CC_O, CPU(V));
+    emit_store(code, AL, CPU(A));
+    emit_set_NZ(code, AL);
+    /* jmp done */
+    done = *code;
+    emit_byte(code, 0xEB);
+    emit_byte(code, 0);
+
+    /* decimal: movzx edi, cl; call mos6507_ADC or mos6507_SBC */
+    decimal[1] = (uint8_t)(*code - (decimal + 2));
+    emit_byte(code, 0x0F);
+    emit_byte(code, 0xB6);
+    emit_byte(code, 0xF9);
+    emit_call(code, subtract ? (const void *)mos6507_SBC : (const void *)mos6507_ADC);
+    done[1] = (uint8_t)(*code - (done + 2));
+    return 1;
+}
+
+/* CMP, CPX, CPY: carry is set unless the subtraction borrows */
+static int emit_compare(uint8_t **code, const decoded_instruction_t *decoded, uint8_t reg)
+{
+    if (!emit_operand(code, decoded)) {
+        return 0;
+    }
+    emit_load(code, AL, reg);
+    emit_alu(code, 0x28);
+    emit_setcc(code, CC_NC, CPU(C));
+    emit_set_NZ(code, AL);
+    return 1;
+}
+
+/* BIT: N and V from bits 7 and 6 of the operand, Z from A & M */
+static int emit_BIT(uint8_t **code, const decoded_instruction_t *decoded)
+{
+    if (!emit_operand(code, decoded)) {
+        return 0;
+    }
+    /* mov al, cl; and al, 0x80 */
+    emit_byte(code, 0x88);
+    emit_byte(code, 0xC8);
+    emit_byte(code, 0x24);
+    emit_byte(code, 0x80);
+    emit_store(code, AL, CPU(N_result));
+    /* mov al, cl; shr al, 6; and al, 1 */
+    emit_byte(code, 0x88);
+    emit_byte(code, 0xC8);
+    emit_byte(code, 0xC0);
+    emit_byte(code, 0xE8);
+    emit_byte(code, 0x06);
+    emit_byte(code, 0x24);
+    emit_byte(code, 0x01);
+    emit_store(code, AL, CPU(V));
+    /* mov al, [rbx+A]; test al, cl; setnz [rbx+Z_result] */
+    emit_load(code, AL, CPU(A));
+    emit_byte(code, 0x84);
+    emit_byte(code, 0xC8);
+    emit_setcc(code, CC_NZ, CPU(Z_result));
+    return 1;
+}
+
+/* ASL, LSR, ROL, ROR on the Accumulator or in memory. shift is the
+ * extension of the host's shift by one (0xD0) op-code: rcl 2, rcr 3,
+ * shl 4 or shr 5
+ */
+static int emit_shift(uint8_t **code, const decoded_instruction_t *decoded, uint8_t shift)
+{
+    uint8_t *memory = 0;
+
+    if (ADDRESSING_IMPLIED == decoded->instruction->mode) {
+        emit_load(code, AL, CPU(A));
+    } else {
+        memory = dynarec_write_memory(decoded);
+        if (!memory) {
+            return 0;
+        }
+        /* mov rsi, memory; mov al, [rsi] */
+        emit_pointer(code, memory);
+        emit_byte(code, 0x8A);
+        emit_byte(code, 0x06);
+    }
+    if (shift == 2 || shift == 3) {
+        emit_carry_in(code, 0);
+    }
+    emit_byte(code, 0xD0);
+    emit_byte(code, 0xC0 | (shift << 3));
+    emit_setcc(code, CC_C, CPU(C));
+    if (shift == 5) {
+        /* As in the microcode, LSR leaves the negative flag alone */
+        emit_setcc(code, CC_NZ, CPU(Z_result));
+    } else {
+        emit_set_NZ(code, AL);
+    }
+    if (memory) {
+        /* mov [rsi], al */
+        emit_byte(code, 0x88);
+        emit_byte(code, 0x06);
+    } else {
+        emit_store(code, AL, CPU(A));
+    }
+    return 1;
+}
+
+/* INC, DEC in memory: mov rsi, memory; mov al, [rsi]; inc/dec al;
+ * mov [rsi], al
+ */
+static int emit_modify(uint8_t **code, const decoded_instruction_t *decoded, int decrement)
+{
+    uint8_t *memory = dynarec_write_memory(decoded);
+
+    if (!memory) {
+        return 0;
+    }
+    emit_pointer(code, memory);
+    emit_byte(code, 0x8A);
+    emit_byte(code, 0x06);
+    emit_byte(code, 0xFE);
+    emit_byte(code, decrement ? 0xC8 : 0xC0);
+    emit_byte(code, 0x88);
+    emit_byte(code, 0x06);
+    emit_set_NZ(code, AL);
+    return 1;
+}
+
+/* INX, INY, DEX, DEY: inc/dec byte [rbx+reg] */
+static int emit_step(uint8_t **code, uint8_t reg, int decrement)
+{
+    emit_rbx(code, 0xFE, decrement ? 1 : 0, reg);
+    emit_load(code, AL, reg);
+    emit_set_NZ(code, AL);
+    return 1;
+}
+
+/* TAX, TAY, TXA, TYA, TSX, TXS */
+static int emit_transfer(uint8_t **code, uint8_t from, uint8_t to, int flags)
+{
+    emit_load(code, AL, from);
+    emit_store(code, AL, to);
+    if (flags) {
+        emit_set_NZ(code, AL);
+    }
+    return 1;
+}
+
+/* CLD, SED, CLI, SEI: and/or byte [rbx+P], flag */
+static int emit_status(uint8_t **code, uint8_t flag, int set)
+{
+    emit_rbx(code, 0x80, set ? 1 : 4, CPU(P));
+    emit_byte(code, set ? flag : (uint8_t)~flag);
+    return 1;
+}
+
+/* Compiles any instruction other than a branch, returning 0 if it can't be */
+static int emit_instruction(uint8_t **code, const decoded_instruction_t *decoded)
+{
+    switch ((uint8_t)(decoded->instruction - instruction_table)) {
+        /* Load and store */
+        case 0xA9: case 0xA5: case 0xAD: return emit_LD(code, decoded, CPU(A));
+        case 0xA2: case 0xA6: case 0xAE: return emit_LD(code, decoded, CPU(X));
+        case 0xA0: case 0xA4: case 0xAC: return emit_LD(code, decoded, CPU(Y));
+        case 0x85: case 0x8D:            return emit_ST(code, decoded, CPU(A));
+        case 0x86: case 0x8E:            return emit_ST(code, decoded, CPU(X));
+        case 0x84: case 0x8C:            return emit_ST(code, decoded, CPU(Y));
+        /* Arithmetic */
+        case 0x69: case 0x65: case 0x6D: return emit_arithmetic(code, decoded, 0);
+        case 0xE9: case 0xE5: case 0xED: return emit_arithmetic(code, decoded, 1);
+        /* Increment and decrement */
+        case 0xE6: case 0xEE:            return emit_modify(code, decoded, 0);
+        case 0xC6: case 0xCE:            return emit_modify(code, decoded, 1);
+        case 0xE8:                       return emit_step(code, CPU(X), 0);
+        case 0xC8:                       return emit_step(code, CPU(Y), 0);
+        case 0xCA:                       return emit_step(code, CPU(X), 1);
+        case 0x88:                       return emit_step(code, CPU(Y), 1);
+        /* Logical */
+        case 0x29: case 0x25: case 0x2D: return emit_logical(code, decoded, 0x20);
+        case 0x49: case 0x45: case 0x4D: return emit_logical(code, decoded, 0x30);
+        case 0x09: case 0x05: case 0x0D: return emit_logical(code, decoded, 0x08);
+        /* Compare and test */
+        case 0xC9: case 0xC5: case 0xCD: return emit_compare(code, decoded, CPU(A));
+        case 0xE0: case 0xE4: case 0xEC: return emit_compare(code, decoded, CPU(X));
+        case 0xC0: case 0xC4: case 0xCC: return emit_compare(code, decoded, CPU(Y));
+        case 0x24: case 0x2C:            return emit_BIT(code, decoded);
+        /* Shift and rotate */
+        case 0x0A: case 0x06: case 0x0E: return emit_shift(code, decoded, 4);
+        case 0x4A: case 0x46: case 0x4E: return emit_shift(code, decoded, 5);
+        case 0x2A: case 0x26: case 0x2E: return emit_shift(code, decoded, 2);
+        case 0x6A: case 0x66: case 0x6E: return emit_shift(code, decoded, 3);
+        /* Transfer */
+        case 0xAA: return emit_transfer(code, CPU(A), CPU(X), 1);
+        case 0xA8: return emit_transfer(code, CPU(A), CPU(Y), 1);
+        case 0x8A: return emit_transfer(code, CPU(X), CPU(A), 1);
+        case 0x98: return emit_transfer(code, CPU(Y), CPU(A), 1);
+        case 0xBA: return emit_transfer(code, CPU(S), CPU(X), 1);
+        /* Unlike the other transfers TXS leaves the status flags alone */
+        case 0x9A: return emit_transfer(code, CPU(X), CPU(S), 0);
+        /* Set and reset */
+        case 0x18: emit_store_imm(code, CPU(C), 0); return 1;
+        case 0x38: emit_store_imm(code, CPU(C), 1); return 1;
+        case 0xB8: emit_store_imm(code, CPU(V), 0); return 1;
+        case 0xD8: return emit_status(code, MOS6507_STATUS_FLAG_DECIMAL, 0);
+        case 0xF8: return emit_status(code, MOS6507_STATUS_FLAG_DECIMAL, 1);
+        case 0x58: return emit_status(code, MOS6507_STATUS_FLAG_INTERRUPT, 0);
+        case 0x78: return emit_status(code, MOS6507_STATUS_FLAG_INTERRUPT, 1);
+        /* Miscellaneous */
+        case 0xEA: return 1;
+        default:   return 0;
+    }
+}
+
+/* Compiles a conditional branch ending a block, with an exit for each
+ * outcome. A branch not taken takes its base cycles, taken adds one more
+ * and another for landing on a different page.
+ *
+ * address: mapped address of the start of the block
+ * offset: of the branch from the start of the block
+ * cycles: clock cycles taken by the block before the branch
+ */
+static void emit_branch(uint8_t **code, const decoded_instruction_t *decoded,
+                        uint16_t address, uint16_t offset, uint32_t cycles)
+{
+    uint8_t opcode = (uint8_t)(decoded->instruction - instruction_table);
+    uint16_t next = offset + 2;
+    uint16_t target = next + (int8_t)decoded->operand[0];
+    uint8_t *skip;
+
+    emit_bus_fetched(code, offset + 1, decoded->operand[0]);
+
+    /* Bits 7-6 of a branch op-code select the flag tested, bit 5 the
+     * value it branches on: cmp byte [rbx+flag], 0 or, for the negative
+     * flag, test byte [rbx+N_result], 0x80
+     */
+    switch (opcode >> 6) {
+        case 0:
+            emit_rbx(code, 0xF6, 0, CPU(N_result));
+            emit_byte(code, 0x80);
+            break;
+        case 1:
+            emit_rbx(code, 0x80, 7, CPU(V));
+            emit_byte(code, 0x00);
+            break;
+        case 2:
+            emit_rbx(code, 0x80, 7, CPU(C));
+            emit_byte(code, 0x00);
+            break;
+        case 3:
+            /* Z_result is 0 when the zero flag is set */
+            emit_rbx(code, 0x80, 7, CPU(Z_result));
+            emit_byte(code, 0x00);
+            break;
+    }
+    /* Jump over the taken exit unless the flag has the value branched on */
+    skip = *code;
+    if ((opcode >> 6) == 3) {
+        emit_byte(code, 0x70 | ((opcode & 0x20) ? CC_NZ : CC_Z));
+    } else {
+        emit_byte(code, 0x70 | ((opcode & 0x20) ? CC_Z : CC_NZ));
+    }
+    emit_byte(code, 0);
+    emit_exit(code, target, cycles + decoded->instruction->cycles + 1 +
+              ((((address + next) ^ (address + target)) & 0xFF00) ? 1 : 0));
+    skip[1] = (uint8_t)(*code - (skip + 2));
+
+    emit_exit(code, next, cycles + decoded->instruction->cycles);
+}
+
+/* Counts the steps of an instruction, including those only run when a
+ * branch is taken or a page is crossed
+ */
+static int dynarec_step_count(const instruction_t *instruction)
+{
+    int i;
+
+    for (i=0; i<OPCODE_MAX_CYCLES && instruction->steps[i]; i++) {
+        /* Count the remaining steps */
+    }
+    return i;
+}
+
+/* Copies a compiled block into the arena, making the arena writable only
+ * for as long as it takes.
+ *
+ * Returns the entry point, or NULL if the arena is unavailable.
+ */
+static dynarec_code_t dynarec_install(const uint8_t *code, size_t size)
+{
+    uint8_t *entry;
+
+    if (!arena) {
+        arena = mmap(0, DYNAREC_ARENA_SIZE, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == arena) {
+            arena = 0;
+            return 0;
+        }
+    }
+    if (arena_used + size > DYNAREC_ARENA_SIZE) {
+        dynarec_invalidate();
+    }
+
+    if (mprotect(arena, DYNAREC_ARENA_SIZE, PROT_READ | PROT_WRITE)) {
+        return 0;
+    }
+    entry = arena + arena_used;
+    memcpy(entry, code, size);
+    if (mprotect(arena, DYNAREC_ARENA_SIZE, PROT_READ | PROT_EXEC)) {
+        /* Nothing in the arena can be run any more */
+        dynarec_invalidate();
+        return 0;
+    }
+    /* Start each block on a fresh 16 byte line */
+    arena_used = (arena_used + size + 15) & ~(size_t)15;
+    return (dynarec_code_t)entry;
+}
+
+/* Compiles the block starting at an address. Blocks of a single
+ * instruction are left to the interpreter as they would gain nothing.
+ *
+ * address: mapped address of the first op-code
+ * worst: set to the clock cycles taken if every branch and page crossing is taken
+ *
+ * Returns the entry point, or NULL if the block wasn't compiled.
+ */
+static dynarec_code_t dynarec_compile(uint16_t address, uint8_t *worst)
+{
+    uint8_t buffer[DYNAREC_CODE_SIZE];
+    uint8_t *code = buffer, *start;
+    const decoded_instruction_t *decoded;
+    decoded_instruction_t last = {0};
+    uint16_t offset = 0, last_offset = 0;
+    uint32_t cycles = 0;
+    int length = 0;
+
+    /* push rbx; mov rbx, cpu */
+    emit_byte(&code, 0x53);
+    emit_byte(&code, 0x48);
+    emit_byte(&code, 0xBB);
+    emit_imm64(&code, (uint64_t)(uintptr_t)mos6507_get_state());
+
+    while (length < DYNAREC_BLOCK_LENGTH) {
+        decoded = decode_cache_lookup(address + offset);
+        if (!decoded) {
+            break;
+        }
+        if (ADDRESSING_RELATIVE == decoded->instruction->mode) {
+            if (!length) {
+                break;
+            }
+            emit_branch(&code, decoded, address, offset, cycles);
+            *worst = cycles + dynarec_step_count(decoded->instruction);
+            return dynarec_install(buffer, code - buffer);
+        }
+        start = code;
+        if (!emit_instruction(&code, decoded)) {
+            code = start;
+            break;
+        }
+        last = *decoded;
+        last_offset = offset;
+        cycles += dynarec_step_count(decoded->instruction);
+        offset += decoded->instruction->length;
+        length++;
+    }
+    if (length < 2) {
+        return 0;
+    }
+
+    /* Leave the last access of the last instruction on the data bus */
+    switch (last.instruction->mode) {
+        case ADDRESSING_IMPLIED:
+            emit_bus_fetched(&code, last_offset, (uint8_t)(last.instruction - instruction_table));
+            break;
+        case ADDRESSING_IMMEDIATE:
+            emit_bus_fetched(&code, last_offset + 1, last.operand[0]);
+            break;
+        default:
+            emit_bus_accessed(&code, dynarec_operand_address(&last),
+                              memmap_get_read_memory(dynarec_operand_address(&last)));
+            break;
+    }
+    emit_exit(&code, offset, cycles);
+    *worst = cycles;
+    return dynarec_install(buffer, code - buffer);
+}
+
+/* Finds the compiled block starting at an address, compiling it once it
+ * has been entered often enough to be worthwhile.
+ *
+ * address: location of the first op-code, as held in the program counter
+ *
+ * Returns NULL if no block has been compiled at the address.
+ */
+const dynarec_block_t * dynarec_lookup(uint16_t address)
+{
+    dynarec_block_t *block;
+    dynarec_code_t code;
+    uint8_t cycles = 0;
+
+    /* Match the mirroring applied by the memory map */
+    address &= 0x1FFF;
+    if (address < MEMMAP_CART_START) {
+        return 0;
+    }
+
+    block = &blocks[address - MEMMAP_CART_START];
+    if (block->code) {
+        return block;
+    }
+    if (block->heat < DYNAREC_HOT_THRESHOLD) {
+        if (++block->heat == DYNAREC_HOT_THRESHOLD) {
+            /* Compiling may flush the arena, and every block with it, so
+             * the block is only filled in afterwards
+             */
+            code = dynarec_compile(address, &cycles);
+            block->heat = DYNAREC_HOT_THRESHOLD;
+            block->cycles = cycles;
+            block->code = code;
+        }
+    }
+    return block->code ? block : 0;
+}
+
+/* Forgets every compiled block and empties the arena */
+void dynarec_invalidate(void)
+{
+    memset(blocks, 0, sizeof(blocks));
+    arena_used = 0;
+}
+
+#endif /* DYNAREC */
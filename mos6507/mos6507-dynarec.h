@@ -0,0 +1,36 @@
+/*
+ * File: mos6507-dynarec.h
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Compiles blocks of cartridge code to native x86-64 code.
+ */
+
+#ifndef _MOS6507_DYNAREC_H
+#define _MOS6507_DYNAREC_H
+
+#include <stdint.h>
+
+/* Blocks are indexed by their offset within the cartridge, so each
+ * address in the 4KB window has its own entry
+ */
+#define DYNAREC_BLOCKS        4096
+#define DYNAREC_BLOCK_LENGTH  16
+#define DYNAREC_ARENA_SIZE    (1024 * 1024)
+
+/* Number of times a block must be entered before it is compiled */
+#define DYNAREC_HOT_THRESHOLD 2
+
+/* Runs a compiled block, returning the number of clock cycles consumed */
+typedef int (*dynarec_code_t)(void);
+
+typedef struct {
+    uint8_t        heat;    /* Times entered, up to DYNAREC_HOT_THRESHOLD */
+    uint8_t        cycles;  /* Clock cycles taken if every branch and page crossing is taken */
+    dynarec_code_t code;    /* Entry point within the arena, NULL if not compiled */
+} dynarec_block_t;
+
+const dynarec_block_t * dynarec_lookup(uint16_t address);
+void dynarec_invalidate(void);
+
+#endif /* _MOS6507_DYNAREC_H */
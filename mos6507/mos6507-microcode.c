@@ -10,6 +10,67 @@
 #include "mos6507-microcode.h"
 #include "mos6507.h"
 
+/* Packed BCD operands converted to binary so decimal mode arithmetic
+ * costs no more than binary mode. Invalid digits (A-F) are weighted as
+ * their binary value, e.g., 0x1F -> 25. Courtesy of stella, M6502.cxx
+ */
+static const uint8_t bcd_to_binary[256] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+    0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
+    0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23,
+    0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D,
+    0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+    0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F, 0x40, 0x41,
+    0x3C, 0x3D, 0x3E, 0x3F, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B,
+    0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55,
+    0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F,
+    0x5A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F, 0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F, 0x70, 0x71, 0x72, 0x73,
+    0x6E, 0x6F, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D,
+    0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x7F, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x8B, 0x8C, 0x8D, 0x8E, 0x8F, 0x90, 0x91,
+    0x8C, 0x8D, 0x8E, 0x8F, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0x9B,
+    0x96, 0x97, 0x98, 0x99, 0x9A, 0x9B, 0x9C, 0x9D, 0x9E, 0x9F, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5
+};
+
+/* Binary results converted back to packed BCD, modulo 100. Sized to
+ * cover any sum or difference of two converted operands masked to 9 bits.
+ */
+static const uint8_t binary_to_bcd[512] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+    0x16, 0x17, 0x18, 0x19, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x30, 0x31,
+    0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+    0x48, 0x49, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x60, 0x61, 0x62, 0x63,
+    0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79,
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95,
+    0x96, 0x97, 0x98, 0x99, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x10, 0x11,
+    0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+    0x28, 0x29, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x40, 0x41, 0x42, 0x43,
+    0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+    0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75,
+    0x76, 0x77, 0x78, 0x79, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x90, 0x91,
+    0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x20, 0x21, 0x22, 0x23,
+    0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+    0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55,
+    0x56, 0x57, 0x58, 0x59, 0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x70, 0x71,
+    0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x00, 0x01, 0x02, 0x03,
+    0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
+    0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35,
+    0x36, 0x37, 0x38, 0x39, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x50, 0x51,
+    0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67,
+    0x68, 0x69, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x80, 0x81, 0x82, 0x83,
+    0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+    0x16, 0x17, 0x18, 0x19, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x30, 0x31,
+    0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+    0x48, 0x49, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x60, 0x61, 0x62, 0x63,
+    0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79,
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95,
+    0x96, 0x97, 0x98, 0x99, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x10, 0x11
+};
+
 /* Add memory to Accumulator.
  * A + M + C -> A, C
  *
@@ -22,6 +83,7 @@ void mos6507_ADC(uint8_t data)
 {
     uint16_t tmp = 0;
     uint8_t accumulator = 0;
+    uint8_t carry = mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY) ? 1 : 0;
     mos6507_get_register(MOS6507_REG_A, &accumulator);
 
     if (mos6507_get_status_flag(MOS6507_STATUS_FLAG_DECIMAL)) {
@@ -29,11 +91,30 @@ void mos6507_ADC(uint8_t data)
          * feature did actually get used by Atari for their port of Asteroids.
          * https://www.youtube.com/watch?v=Ne1ApyqSvm0 (55:00)
          */
+        uint16_t low = (accumulator & 0x0F) + (data & 0x0F) + carry;
+        uint16_t intermediate = 0;
+
+        /* As on the NMOS 6502, zero follows the binary sum while negative
+         * and overflow follow the sum once the low digit is adjusted
+         */
+        if (low > 9) {
+            low = ((low + 6) & 0x0F) + 0x10;
+        }
+        intermediate = (accumulator & 0xF0) + (data & 0xF0) + low;
+        mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO,
+            !((accumulator + data + carry) & 0xFF));
+        mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (intermediate & 0x80));
+        mos6507_set_status_flag(
+            MOS6507_STATUS_FLAG_OVERFLOW,
+            !((accumulator ^ data) & 0x80) && ((accumulator ^ intermediate) & 0x80)
+        );
+
+        tmp = bcd_to_binary[accumulator] + bcd_to_binary[data] + carry;
+        mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, (tmp > 99));
+        tmp = binary_to_bcd[tmp];
     } else {
-        tmp = data + accumulator + (mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY) ? 1 : 0);
-        mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-        mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, (tmp > 0xFF));
-        mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
+        tmp = data + accumulator + carry;
+        mos6507_set_NZC((tmp & 0xFF), (tmp > 0xFF));
         mos6507_set_status_flag(
             MOS6507_STATUS_FLAG_OVERFLOW,
             !((accumulator ^ data) & 0x80) && ((accumulator ^ tmp) & 0x80)
@@ -57,8 +138,7 @@ void mos6507_AND(uint8_t data)
     mos6507_get_register(MOS6507_REG_A, &accumulator);
 
     tmp = accumulator & data;
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
+    mos6507_set_NZ(tmp);
 
     mos6507_set_register(MOS6507_REG_A, tmp);
 }
@@ -76,9 +156,7 @@ void mos6507_ASL(uint8_t *data)
     uint16_t tmp = *data;
 
     tmp <<= 1;
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, (tmp & 0x100));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
+    mos6507_set_NZC((tmp & 0xFF), (tmp & 0x100));
 
     *data = (tmp & 0xFF);
 }
@@ -99,9 +177,7 @@ void mos6507_ASL_Accumulator(void)
     tmp = accumulator;
 
     tmp <<= 1;
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, (tmp & 0x100));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
+    mos6507_set_NZC((tmp & 0xFF), (tmp & 0x100));
 
     accumulator = (tmp & 0xFF);
     mos6507_set_register(MOS6507_REG_A, accumulator);
@@ -145,9 +221,7 @@ void mos6507_CMP(uint8_t data)
     mos6507_get_register(MOS6507_REG_A, &accumulator);
 
     tmp = accumulator - data;
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, (tmp < 0x0100));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
+    mos6507_set_NZC((tmp & 0xFF), (tmp < 0x0100));
 }
 
 /* Compare memory with Index X.
@@ -166,9 +240,7 @@ void mos6507_CPX(uint8_t data)
     mos6507_get_register(MOS6507_REG_X, &X);
 
     tmp = X - data;
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, (tmp < 0x0100));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
+    mos6507_set_NZC((tmp & 0xFF), (tmp < 0x0100));
 }
 
 /* Compare memory with Index Y.
@@ -187,9 +259,7 @@ void mos6507_CPY(uint8_t data)
     mos6507_get_register(MOS6507_REG_Y, &Y);
 
     tmp = Y - data;
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, (tmp < 0x0100));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
+    mos6507_set_NZC((tmp & 0xFF), (tmp < 0x0100));
 }
 
 /* Exclusive OR memory with Accumulator.
@@ -207,8 +277,7 @@ void mos6507_EOR(uint8_t data)
 
     tmp = accumulator ^ data;
 
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
+    mos6507_set_NZ(tmp);
     mos6507_set_register(MOS6507_REG_A, tmp);
 }
 
@@ -260,8 +329,7 @@ void mos6507_ORA(uint8_t *data)
 
     tmp = accumulator | *data;
 
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
+    mos6507_set_NZ(tmp);
     mos6507_set_register(MOS6507_REG_A, tmp);
 }
 
@@ -281,9 +349,7 @@ void mos6507_ROL(uint8_t *data)
     if (mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY)) {
         tmp |= 0x01;
     }
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, (tmp & 0x0100));
+    mos6507_set_NZC((tmp & 0xFF), (tmp & 0x0100));
     *data = (tmp & 0xFF);
 }
 
@@ -305,9 +371,7 @@ void mos6507_ROL_Accumulator(void)
     if (mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY)) {
         tmp |= 0x01;
     }
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, (tmp & 0x0100));
+    mos6507_set_NZC((tmp & 0xFF), (tmp & 0x0100));
     accumulator = (tmp & 0xFF);
     mos6507_set_register(MOS6507_REG_A, accumulator);
 }
@@ -330,9 +394,7 @@ void mos6507_ROR(uint8_t *data)
     if (mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY)) {
         tmp |= 0x80;
     }
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, tmpCarry);
+    mos6507_set_NZC((tmp & 0xFF), tmpCarry);
     *data = (tmp & 0xFF);
 }
 
@@ -355,9 +417,7 @@ void mos6507_ROR_Accumulator(void)
     if (mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY)) {
         tmp |= 0x80;
     }
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, tmpCarry);
+    mos6507_set_NZC((tmp & 0xFF), tmpCarry);
     accumulator = (tmp & 0xFF);
     mos6507_set_register(MOS6507_REG_A, accumulator);
 }
@@ -373,19 +433,26 @@ void mos6507_SBC(uint8_t data)
 {
     uint16_t tmp = 0;
     uint8_t accumulator = 0;
+    /* Carry clear indicates a borrow */
+    uint8_t borrow = mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY) ? 0 : 1;
     mos6507_get_register(MOS6507_REG_A, &accumulator);
 
+    /* On the NMOS 6502 every flag follows the binary subtraction, even in
+     * decimal mode
+     */
+    tmp = accumulator - data - borrow;
+    mos6507_set_NZC((tmp & 0xFF), !(tmp & 0x8000));
+    mos6507_set_status_flag(
+        MOS6507_STATUS_FLAG_OVERFLOW,
+        ((accumulator ^ data) & 0x80) && ((accumulator ^ tmp) & 0x80)
+    );
+
     if (mos6507_get_status_flag(MOS6507_STATUS_FLAG_DECIMAL)) {
-        // TODO
-    } else {
-        tmp = accumulator - data - (mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY) ? 1 : 0);
-        mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (tmp & 0x80));
-        mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, !(tmp & 0x8000));
-        mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(tmp & 0xFF));
-        mos6507_set_status_flag(
-            MOS6507_STATUS_FLAG_OVERFLOW,
-            !((accumulator ^ data) & 0x80) && ((accumulator ^ tmp) & 0x80)
-        );
+        tmp = bcd_to_binary[accumulator] - bcd_to_binary[data] - borrow;
+        if (tmp & 0x8000) {
+            tmp += 100;
+        }
+        tmp = binary_to_bcd[tmp & 0x1FF];
     }
 
     mos6507_set_register(MOS6507_REG_A, (tmp & 0xFF));
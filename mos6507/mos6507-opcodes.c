@@ -16,1580 +16,1172 @@
 #include "mos6507.h"
 #include "mos6507-opcodes.h"
 #include "mos6507-microcode.h"
+#include "mos6507-decode-cache.h"
 #include "mos6507-addressing-macros.h"
 
-/* Invoked at the end of each op-code. Resets the
- * clock cycle counter and increments the PC and 
- * address busses for the next op-code
+/* Invoked at the end of each op-code. Increments the
+ * PC for the next op-code
  */
 #define END_OPCODE() \
-    mos6507_increment_PC(); \
-    mos6507_set_address_bus(mos6507_get_PC());
+    mos6507_increment_PC();
 
-#define STACK_PAGE 0x01
-
-instruction_t ISA_table[ISA_LENGTH];
+/* Internal latches holding the operands of the instruction currently
+ * in flight. Naming follows the MOS hardware manual: ADL/ADH hold the
+ * effective address, BAL/BAH a base address prior to indexing and IAL
+ * an indirect address in zero page.
+ */
+static struct {
+    uint8_t adl;
+    uint8_t adh;
+    uint8_t bal;
+    uint8_t bah;
+    uint8_t ial;
+    uint8_t data;
+    uint16_t addr;
+} latch;
+
+/* Cached decode of the instruction in flight, if it was fetched from the
+ * cartridge, and the address its op-code was fetched from.
+ */
+static const decoded_instruction_t *decoded = 0;
+static uint16_t decoded_PC = 0;
 
-/* Looks up an instruction from the instruction table and
- * executes the corresponding function, passing along cycle
- * time and addressing mode.
+/* Fetches the op-code at the program counter, taking it from the decode
+ * cache where possible so its operands need not be read through the
+ * memory map either.
  *
- * opcode: value of the instruction, e.g., 0x00 for BRK
+ * opcode: the fetched op-code
  */
-int opcode_execute(uint8_t opcode)
+void opcode_fetch(uint8_t *opcode)
 {
-    static int cycle = 0;
-    if (-1 == ISA_table[opcode].opcode(cycle, ISA_table[opcode].addressing_mode)) {
-        cycle++;
+    decoded_PC = mos6507_get_PC();
+    decoded = decode_cache_lookup(decoded_PC);
+    if (decoded) {
+        *opcode = (uint8_t)(decoded->instruction - instruction_table);
+        memmap_bus_fetched(decoded_PC, *opcode);
     } else {
-        cycle = 0;
+        *opcode = memmap_bus_read(decoded_PC);
     }
-    return cycle;
 }
 
-int opcode_validate(uint8_t opcode)
+/* Runs a single clock cycle of an instruction by looking up the
+ * pre-decoded step for that op-code and cycle.
+ *
+ * opcode: value of the instruction, e.g., 0x00 for BRK
+ * cycle: clock cycle within the instruction, starting at 0
+ *
+ * Returns the next cycle of the instruction, or 0 once complete.
+ */
+int opcode_execute(uint8_t opcode, uint8_t cycle)
 {
-    if (ISA_table[opcode].opcode == opcode_ILL) {
-        return -1;
+    if (-1 == instruction_table[opcode].steps[cycle]()) {
+        return cycle + 1;
     }
     return 0;
 }
 
-/* Loads an array with function pointers to the corresponding
- * instruction. E.g., LDY is 0x0C so index 12 of the ISA table
- * would be loaded with a pointer to function opcode_LDY().
+/* Makes an instruction already decoded from the cartridge the one in
+ * flight, as if its op-code had just been fetched from the program
+ * counter, so its steps take their operands from it.
+ *
+ * instruction: decoded instruction located at the program counter
  */
-void opcode_populate_ISA_table(void)
+void opcode_bind(const decoded_instruction_t *instruction)
 {
-    int i = 0;
-    /* Initially, fill the entire table with ILL */
-    for (i=0; i<ISA_LENGTH; i++) {
-        ISA_table[i].opcode = opcode_ILL;
-        ISA_table[i].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-    }
-
-    /* Now fill out the actual codes supported by a real 6507 */
-
-    /* 0x00: BRK, Implied */
-    ISA_table[0x00].opcode = opcode_BRK;
-    ISA_table[0x00].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Load accumulator with memory */
-    ISA_table[0xA9].opcode = opcode_LDA;
-    ISA_table[0xA9].addressing_mode = OPCODE_ADDRESSING_MODE_IMMEDIATE;
-    ISA_table[0xA5].opcode = opcode_LDA;
-    ISA_table[0xA5].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0xB5].opcode = opcode_LDA;
-    ISA_table[0xB5].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0xAD].opcode = opcode_LDA;
-    ISA_table[0xAD].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0xBD].opcode = opcode_LDA;
-    ISA_table[0xBD].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-    ISA_table[0xB9].opcode = opcode_LDA;
-    ISA_table[0xB9].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED;
-    ISA_table[0xA1].opcode = opcode_LDA;
-    ISA_table[0xA1].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_X_INDEXED;
-    ISA_table[0xB1].opcode = opcode_LDA;
-    ISA_table[0xB1].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_Y_INDEXED;
-
-    /* Load Index X with memory */
-    ISA_table[0xA2].opcode = opcode_LDX;
-    ISA_table[0xA2].addressing_mode = OPCODE_ADDRESSING_MODE_IMMEDIATE;
-    ISA_table[0xA6].opcode = opcode_LDX;
-    ISA_table[0xA6].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0xB6].opcode = opcode_LDX;
-    ISA_table[0xB6].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_Y_INDEXED;
-    ISA_table[0xAE].opcode = opcode_LDX;
-    ISA_table[0xAE].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0xBE].opcode = opcode_LDX;
-    ISA_table[0xBE].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED;
-
-    /* Load Index Y with memory */
-    ISA_table[0xA0].opcode = opcode_LDY;
-    ISA_table[0xA0].addressing_mode = OPCODE_ADDRESSING_MODE_IMMEDIATE;
-    ISA_table[0xA4].opcode = opcode_LDY;
-    ISA_table[0xA4].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0xB4].opcode = opcode_LDY;
-    ISA_table[0xB4].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0xAC].opcode = opcode_LDY;
-    ISA_table[0xAC].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0xBC].opcode = opcode_LDY;
-    ISA_table[0xBC].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-
-    /* Store Accumulator in memory */
-    ISA_table[0x85].opcode = opcode_STA;
-    ISA_table[0x85].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x95].opcode = opcode_STA;
-    ISA_table[0x95].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0x8D].opcode = opcode_STA;
-    ISA_table[0x8D].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0x9D].opcode = opcode_STA;
-    ISA_table[0x9D].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-    ISA_table[0x99].opcode = opcode_STA;
-    ISA_table[0x99].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED;
-    ISA_table[0x81].opcode = opcode_STA;
-    ISA_table[0x81].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_X_INDEXED;
-    ISA_table[0x91].opcode = opcode_STA;
-    ISA_table[0x91].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_Y_INDEXED;
-
-    /* Store Index X in memory */
-    ISA_table[0x86].opcode = opcode_STX;
-    ISA_table[0x86].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x96].opcode = opcode_STX;
-    ISA_table[0x96].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_Y_INDEXED;
-    ISA_table[0x8E].opcode = opcode_STX;
-    ISA_table[0x8E].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-
-    /* Store Index Y in memory */
-    ISA_table[0x84].opcode = opcode_STY;
-    ISA_table[0x84].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x94].opcode = opcode_STY;
-    ISA_table[0x94].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0x8C].opcode = opcode_STY;
-    ISA_table[0x8C].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-
-    /* Add memory to Accumulator with carry */
-    ISA_table[0x69].opcode = opcode_ADC;
-    ISA_table[0x69].addressing_mode = OPCODE_ADDRESSING_MODE_IMMEDIATE;
-    ISA_table[0x65].opcode = opcode_ADC;
-    ISA_table[0x65].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x75].opcode = opcode_ADC;
-    ISA_table[0x75].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0x6D].opcode = opcode_ADC;
-    ISA_table[0x6D].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0x7D].opcode = opcode_ADC;
-    ISA_table[0x7D].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-    ISA_table[0x79].opcode = opcode_ADC;
-    ISA_table[0x79].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED;
-    ISA_table[0x61].opcode = opcode_ADC;
-    ISA_table[0x61].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_X_INDEXED;
-    ISA_table[0x71].opcode = opcode_ADC;
-    ISA_table[0x71].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_Y_INDEXED;
-
-    /* Subtract memory from Accumulator with borrow */
-    ISA_table[0xE9].opcode = opcode_SBC;
-    ISA_table[0xE9].addressing_mode = OPCODE_ADDRESSING_MODE_IMMEDIATE;
-    ISA_table[0xE5].opcode = opcode_SBC;
-    ISA_table[0xE5].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0xF5].opcode = opcode_SBC;
-    ISA_table[0xF5].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0xED].opcode = opcode_SBC;
-    ISA_table[0xED].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0xFD].opcode = opcode_SBC;
-    ISA_table[0xFD].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-    ISA_table[0xF9].opcode = opcode_SBC;
-    ISA_table[0xF9].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED;
-    ISA_table[0xE1].opcode = opcode_SBC;
-    ISA_table[0xE1].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_X_INDEXED;
-    ISA_table[0xF1].opcode = opcode_SBC;
-    ISA_table[0xF1].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_Y_INDEXED;
-
-    /* Increment memory by one */
-    ISA_table[0xE6].opcode = opcode_INC;
-    ISA_table[0xE6].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0xF6].opcode = opcode_INC;
-    ISA_table[0xF6].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0xEE].opcode = opcode_INC;
-    ISA_table[0xEE].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0xFE].opcode = opcode_INC;
-    ISA_table[0xFE].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-
-    /* Increment Index X by one */
-    ISA_table[0xE8].opcode = opcode_INX;
-    ISA_table[0xE8].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Increment Index Y by one */
-    ISA_table[0xC8].opcode = opcode_INY;
-    ISA_table[0xC8].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Decrement memory by one */
-    ISA_table[0xC6].opcode = opcode_DEC;
-    ISA_table[0xC6].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0xD6].opcode = opcode_DEC;
-    ISA_table[0xD6].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0xCE].opcode = opcode_DEC;
-    ISA_table[0xCE].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0xDE].opcode = opcode_DEC;
-    ISA_table[0xDE].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-
-    /* Decrement Index X by one */
-    ISA_table[0xCA].opcode = opcode_DEX;
-    ISA_table[0xCA].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Decrement Index Y by one */
-    ISA_table[0x88].opcode = opcode_DEY;
-    ISA_table[0x88].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Logical AND with Accumulator */
-    ISA_table[0x21].opcode = opcode_AND;
-    ISA_table[0x21].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_X_INDEXED;
-    ISA_table[0x25].opcode = opcode_AND;
-    ISA_table[0x25].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x29].opcode = opcode_AND;
-    ISA_table[0x29].addressing_mode = OPCODE_ADDRESSING_MODE_IMMEDIATE;
-    ISA_table[0x2D].opcode = opcode_AND;
-    ISA_table[0x2D].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0x31].opcode = opcode_AND;
-    ISA_table[0x31].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_Y_INDEXED;
-    ISA_table[0x35].opcode = opcode_AND;
-    ISA_table[0x35].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0x39].opcode = opcode_AND;
-    ISA_table[0x39].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED;
-    ISA_table[0x3D].opcode = opcode_AND;
-    ISA_table[0x3D].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-
-    /* Logical OR with Accumulator */
-    ISA_table[0x01].opcode = opcode_ORA;
-    ISA_table[0x01].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_X_INDEXED;
-    ISA_table[0x05].opcode = opcode_ORA;
-    ISA_table[0x05].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x09].opcode = opcode_ORA;
-    ISA_table[0x09].addressing_mode = OPCODE_ADDRESSING_MODE_IMMEDIATE;
-    ISA_table[0x0D].opcode = opcode_ORA;
-    ISA_table[0x0D].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0x11].opcode = opcode_ORA;
-    ISA_table[0x11].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_Y_INDEXED;
-    ISA_table[0x15].opcode = opcode_ORA;
-    ISA_table[0x15].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0x19].opcode = opcode_ORA;
-    ISA_table[0x19].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED;
-    ISA_table[0x1D].opcode = opcode_ORA;
-    ISA_table[0x1D].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-
-    /* logical exclusive OR with Accumulator */
-    ISA_table[0x41].opcode = opcode_EOR;
-    ISA_table[0x41].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_X_INDEXED;
-    ISA_table[0x45].opcode = opcode_EOR;
-    ISA_table[0x45].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x49].opcode = opcode_EOR;
-    ISA_table[0x49].addressing_mode = OPCODE_ADDRESSING_MODE_IMMEDIATE;
-    ISA_table[0x4D].opcode = opcode_EOR;
-    ISA_table[0x4D].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0x51].opcode = opcode_EOR;
-    ISA_table[0x51].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_Y_INDEXED;
-    ISA_table[0x55].opcode = opcode_EOR;
-    ISA_table[0x55].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0x59].opcode = opcode_EOR;
-    ISA_table[0x59].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED;
-    ISA_table[0x5D].opcode = opcode_EOR;
-    ISA_table[0x5D].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-
-    /* Jump to new location */
-    ISA_table[0x4C].opcode = opcode_JMP;
-    ISA_table[0x4c].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0x6C].opcode = opcode_JMP;
-    ISA_table[0x6C].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT;
-
-    /* Branch on carry clear */
-    ISA_table[0x90].opcode = opcode_BCC;
-    ISA_table[0x90].addressing_mode = OPCODE_ADDRESSING_MODE_RELATIVE;
-
-    /* Branch on carry set */
-    ISA_table[0xB0].opcode = opcode_BCS;
-    ISA_table[0xB0].addressing_mode = OPCODE_ADDRESSING_MODE_RELATIVE;
-
-    /* Branch on result zero */
-    ISA_table[0xF0].opcode = opcode_BEQ;
-    ISA_table[0xF0].addressing_mode = OPCODE_ADDRESSING_MODE_RELATIVE;
-
-    /* Branch on result not zero */
-    ISA_table[0xD0].opcode = opcode_BNE;
-    ISA_table[0xD0].addressing_mode = OPCODE_ADDRESSING_MODE_RELATIVE;
-
-    /* Branch on result not zero */
-    ISA_table[0x30].opcode = opcode_BMI;
-    ISA_table[0x30].addressing_mode = OPCODE_ADDRESSING_MODE_RELATIVE;
-
-    /* Branch on result plus */
-    ISA_table[0x10].opcode = opcode_BPL;
-    ISA_table[0x10].addressing_mode = OPCODE_ADDRESSING_MODE_RELATIVE;
-
-    /* Branch on overflow set */
-    ISA_table[0x70].opcode = opcode_BVS;
-    ISA_table[0x70].addressing_mode = OPCODE_ADDRESSING_MODE_RELATIVE;
-
-    /* Branch on overflow clear */
-    ISA_table[0x50].opcode = opcode_BVC;
-    ISA_table[0x50].addressing_mode = OPCODE_ADDRESSING_MODE_RELATIVE;
-
-    /* Compare with Accumulator*/
-    ISA_table[0xC9].opcode = opcode_CMP;
-    ISA_table[0xC9].addressing_mode = OPCODE_ADDRESSING_MODE_IMMEDIATE;
-    ISA_table[0xC5].opcode = opcode_CMP;
-    ISA_table[0xC5].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0xD5].opcode = opcode_CMP;
-    ISA_table[0xD5].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0xCD].opcode = opcode_CMP;
-    ISA_table[0xCD].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0xDD].opcode = opcode_CMP;
-    ISA_table[0xDD].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-    ISA_table[0xD9].opcode = opcode_CMP;
-    ISA_table[0xD9].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED;
-    ISA_table[0xC1].opcode = opcode_CMP;
-    ISA_table[0xC1].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_X_INDEXED;
-    ISA_table[0xD1].opcode = opcode_CMP;
-    ISA_table[0xD1].addressing_mode = OPCODE_ADDRESSING_MODE_INDIRECT_Y_INDEXED;
-
-    /* Compare memory with Index X */
-    ISA_table[0xE0].opcode = opcode_CPX;
-    ISA_table[0xE0].addressing_mode = OPCODE_ADDRESSING_MODE_IMMEDIATE;
-    ISA_table[0xE4].opcode = opcode_CPX;
-    ISA_table[0xE4].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0xEC].opcode = opcode_CPX;
-    ISA_table[0xEC].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-
-    /* Compare memory with Index Y */
-    ISA_table[0xC0].opcode = opcode_CPY;
-    ISA_table[0xC0].addressing_mode = OPCODE_ADDRESSING_MODE_IMMEDIATE;
-    ISA_table[0xC4].opcode = opcode_CPY;
-    ISA_table[0xC4].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0xCC].opcode = opcode_CPY;
-    ISA_table[0xCC].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-
-    /* Test bits in memory with Accumulator */
-    ISA_table[0x24].opcode = opcode_BIT;
-    ISA_table[0x24].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x2C].opcode = opcode_BIT;
-    ISA_table[0x2C].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-
-    /* Shift left one bit */
-    ISA_table[0x0A].opcode = opcode_ASL;
-    ISA_table[0x0A].addressing_mode = OPCODE_ADDRESSING_MODE_ACCUMULATOR;
-    ISA_table[0x06].opcode = opcode_ASL;
-    ISA_table[0x06].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x16].opcode = opcode_ASL;
-    ISA_table[0x16].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0x0E].opcode = opcode_ASL;
-    ISA_table[0x0E].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0x1E].opcode = opcode_ASL;
-    ISA_table[0x1E].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-
-    /* Right shift one bit */
-    ISA_table[0x4A].opcode = opcode_LSR;
-    ISA_table[0x4A].addressing_mode = OPCODE_ADDRESSING_MODE_ACCUMULATOR;
-    ISA_table[0x46].opcode = opcode_LSR;
-    ISA_table[0x46].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x56].opcode = opcode_LSR;
-    ISA_table[0x56].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0x4E].opcode = opcode_LSR;
-    ISA_table[0x4E].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0x5E].opcode = opcode_LSR;
-    ISA_table[0x5E].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-
-    /* Rotate one bit left */
-    ISA_table[0x2A].opcode = opcode_ROL;
-    ISA_table[0x2A].addressing_mode = OPCODE_ADDRESSING_MODE_ACCUMULATOR;
-    ISA_table[0x26].opcode = opcode_ROL;
-    ISA_table[0x26].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x36].opcode = opcode_ROL;
-    ISA_table[0x36].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0x2E].opcode = opcode_ROL;
-    ISA_table[0x2E].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0x3E].opcode = opcode_ROL;
-    ISA_table[0x3E].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-
-    /* Rotate one bit right */
-    ISA_table[0x6A].opcode = opcode_ROR;
-    ISA_table[0x6A].addressing_mode = OPCODE_ADDRESSING_MODE_ACCUMULATOR;
-    ISA_table[0x66].opcode = opcode_ROR;
-    ISA_table[0x66].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE;
-    ISA_table[0x76].opcode = opcode_ROR;
-    ISA_table[0x76].addressing_mode = OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED;
-    ISA_table[0x6E].opcode = opcode_ROR;
-    ISA_table[0x6E].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-    ISA_table[0x7E].opcode = opcode_ROR;
-    ISA_table[0x7E].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED;
-
-    /* Transfer Accumulator to Index X */
-    ISA_table[0xAA].opcode = opcode_TAX;
-    ISA_table[0xAA].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Transfer Accumulator to Index Y */
-    ISA_table[0xA8].opcode = opcode_TAY;
-    ISA_table[0xA8].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Transfer Index X to Accumulator */
-    ISA_table[0x8A].opcode = opcode_TXA;
-    ISA_table[0x8A].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Transfer Index Y to Accumulator */
-    ISA_table[0x98].opcode = opcode_TYA;
-    ISA_table[0x98].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Transfer stack pointer to Index X */
-    ISA_table[0xBA].opcode = opcode_TSX;
-    ISA_table[0xBA].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Transfer Index X to stack register */
-    ISA_table[0x9A].opcode = opcode_TXS;
-    ISA_table[0x9A].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Push Accumulator onto stack */
-    ISA_table[0x48].opcode = opcode_PHA;
-    ISA_table[0x48].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Push processor status onto stack */
-    ISA_table[0x08].opcode = opcode_PHP;
-    ISA_table[0x08].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Pull Accumulator from stack */
-    ISA_table[0x68].opcode = opcode_PLA;
-    ISA_table[0x68].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Pull processor status from stack */
-    ISA_table[0x28].opcode = opcode_PLP;
-    ISA_table[0x28].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Jump to new location saving return address */
-    ISA_table[0x20].opcode = opcode_JSR;
-    ISA_table[0x20].addressing_mode = OPCODE_ADDRESSING_MODE_ABSOLUTE;
-
-    /* Return from subroutine */
-    ISA_table[0x60].opcode = opcode_RTS;
-    ISA_table[0x60].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Return from interrupt */
-    ISA_table[0x40].opcode = opcode_RTI;
-    ISA_table[0x40].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Clear carry flag */
-    ISA_table[0x18].opcode = opcode_CLC;
-    ISA_table[0x18].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Clear decimal mode */
-    ISA_table[0xD8].opcode = opcode_CLD;
-    ISA_table[0xD8].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Clear interrupt disable bit */
-    ISA_table[0x58].opcode = opcode_CLI;
-    ISA_table[0x58].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Clear overflow bit */
-    ISA_table[0xB8].opcode = opcode_CLV;
-    ISA_table[0xB8].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
-
-    /* Set carry flag */
-    ISA_table[0x38].opcode = opcode_SEC;
-    ISA_table[0x38].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
+    decoded = instruction;
+    decoded_PC = mos6507_get_PC();
+    memmap_bus_fetched(decoded_PC, (uint8_t)(instruction->instruction - instruction_table));
+}
 
-    /* Set decimal flag */
-    ISA_table[0xF8].opcode = opcode_SED;
-    ISA_table[0xF8].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
+/* Reports the instruction in flight, if it was decoded from the cartridge,
+ * so an access it makes can be related back to the code making it.
+ *
+ * instruction: decoded instruction in flight, NULL if not from the cartridge
+ * address: location its op-code was fetched from
+ */
+void opcode_get_decoded(const decoded_instruction_t **instruction, uint16_t *address)
+{
+    *instruction = decoded;
+    *address = decoded_PC;
+}
 
-    /* Set interrupt disable status */
-    ISA_table[0x78].opcode = opcode_SEI;
-    ISA_table[0x78].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
+/* Runs a block of instructions already decoded from the cartridge back to
+ * back, calling each step in turn rather than dispatching on the op-code
+ * every cycle. The cycle in progress isn't tracked, so none of the
+ * instructions may access the TIA or RIOT.
+ *
+ * instructions: decoded instructions, in program order from the PC
+ * count: number of instructions to run
+ *
+ * Returns the number of clock cycles consumed.
+ */
+int opcode_execute_block(const decoded_instruction_t *instructions, int count)
+{
+    const step_t *step;
+    int i, cycles = 0;
+
+    for (i=0; i<count; i++) {
+        opcode_bind(&instructions[i]);
+        step = decoded->instruction->steps;
+        while (-1 == (*step++)()) {
+            /* Continue to the next cycle */
+        }
+        cycles += step - decoded->instruction->steps;
+    }
+    return cycles;
+}
 
-    /* No operation */
-    ISA_table[0xEA].opcode = opcode_NOP;
-    ISA_table[0xEA].addressing_mode = OPCODE_ADDRESSING_MODE_IMPLIED;
+int opcode_validate(uint8_t opcode)
+{
+    /* This is part of the program logic rather than the 6507 model. Further
+     * work could include fleshing out the illegal opcodes with their
+     * real-world actions depending on which specific 6507 implementation
+     * is being emulated?
+     */
+    if (!instruction_table[opcode].steps[0]) {
+        return -1;
+    }
+    return 0;
 }
 
 /******************************************************************************
- * Instruction set implementation
+ * Addressing steps
  *
- * These functions exist to wrapper the logical instruction (e.g., ADD, ROR,
- * MOV etc) with the necessary clock steps and memory access methods to make
- * the emulation cycle accurate. Actual op-code logic is implemented in
- * mos6507-microcode.c which has no knowledge of the memory map beyond what is
- * actually present in the CPU itself.
+ * Each function here implements one clock cycle of an addressing mode. They
+ * are combined into complete instructions by the macros in
+ * mos6507-addressing-macros.h, with the final step invoking the operation
+ * passed along with it.
  *****************************************************************************/
 
-int opcode_ILL(int cycle, addressing_mode_t address_mode)
+/* Reads the next byte of the instruction stream */
+static void fetch_operand(uint8_t *operand)
 {
-    /* Halt and catch fire!! */
-    return 0;
+    uint16_t index;
+
+    mos6507_increment_PC();
+    index = mos6507_get_PC() - decoded_PC - 1;
+    if (decoded && index < decoded->instruction->length - 1) {
+        *operand = decoded->operand[index];
+        memmap_bus_fetched(mos6507_get_PC(), *operand);
+    } else {
+        *operand = memmap_bus_read(mos6507_get_PC());
+    }
 }
 
-int opcode_ADC(int cycle, addressing_mode_t address_mode)
+/* Adds an index register to the base address, giving the effective
+ * address. Returns 1 if a page boundary was crossed.
+ */
+static int index_base_address(mos6507_register_t reg)
 {
-    static uint8_t adl, adh, ial, bal, bah, data = 0;
-    uint8_t X, Y, c = 0;
+    uint8_t index, c = 0;
 
-    FETCH_DATA()
-    mos6507_ADC(data);
-    END_OPCODE()
-    return 0;
+    mos6507_get_register(reg, &index);
+    latch.adl = latch.bal + index;
+    if ((latch.bal + index) & 0x0100) {
+        c = 1;
+    }
+    latch.adh = latch.bah + c;
+    latch.addr = (latch.adh << 8) | latch.adl;
+    return c;
 }
 
-int opcode_AND(int cycle, addressing_mode_t address_mode)
+static void index_zero_page(mos6507_register_t reg)
 {
-    static uint8_t adl, adh, ial, bal, bah, data = 0;
-    uint8_t X, Y, c = 0;
+    uint8_t index;
 
-    FETCH_DATA()
-    mos6507_AND(data);
-    END_OPCODE()
-    return 0;
+    mos6507_get_register(reg, &index);
+    latch.addr = (uint8_t)(latch.bal + index);
 }
 
-int opcode_ASL(int cycle, addressing_mode_t address_mode)
+/* Final cycle of an instruction reading from the effective address */
+static int read_data(operation_t operation)
 {
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
-
-    if (OPCODE_ADDRESSING_MODE_ACCUMULATOR == address_mode) {
-        switch(cycle) {
-            case 0:
-                /* Consume clock cycle for fetching op-code */
-                return -1;
-            case 1:
-                mos6507_ASL_Accumulator();
-                /* Intentional fall-through */
-            default:
-                /* End of op-code execution */
-                break;
-        }
-        END_OPCODE()
-        return 0;
-    }
-
-    FETCH_DATA()
-    mos6507_ASL(&data);
+    latch.data = memmap_bus_read(latch.addr);
+    operation(&latch.data);
     END_OPCODE()
     return 0;
 }
 
-int opcode_BCC(int cycle, addressing_mode_t address_mode)
+/* Final cycle of an instruction writing to the effective address */
+static int write_data(operation_t operation)
 {
-    static uint8_t condition, offset = 0;
-    static uint16_t addr = 0;
-    uint8_t compliment = 0;
-
-    condition = !mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY);
-
-    CALC_BRANCH()
-
-    mos6507_set_address_bus(mos6507_get_PC());
+    operation(&latch.data);
+    memmap_bus_write(latch.addr, latch.data);
+    END_OPCODE()
     return 0;
 }
 
-int opcode_BCS(int cycle, addressing_mode_t address_mode)
+/* Final cycle of an instruction modifying memory in place */
+static int modify_data(operation_t operation)
 {
-    static uint8_t condition, offset = 0;
-    static uint16_t addr = 0;
-    uint8_t compliment = 0;
-
-    condition = mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY);
-
-    CALC_BRANCH()
-
-    mos6507_set_address_bus(mos6507_get_PC());
+    latch.data = memmap_bus_read(latch.addr);
+    operation(&latch.data);
+    memmap_bus_write(latch.addr, latch.data);
+    END_OPCODE()
     return 0;
 }
 
-int opcode_BEQ(int cycle, addressing_mode_t address_mode)
+static int step_fetch_opcode(void)
 {
-    static uint8_t condition, offset = 0;
-    static uint16_t addr = 0;
-    uint8_t compliment = 0;
-
-    condition = mos6507_get_status_flag(MOS6507_STATUS_FLAG_ZERO);
-
-    CALC_BRANCH()
-
-    mos6507_set_address_bus(mos6507_get_PC());
-    return 0;
+    /* Consume clock cycle for fetching op-code */
+    return -1;
 }
 
-int opcode_BIT(int cycle, addressing_mode_t address_mode)
+static int step_implied(operation_t operation)
 {
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
-
-    FETCH_DATA()
-    mos6507_BIT(data);
+    operation(&latch.data);
     END_OPCODE()
     return 0;
 }
 
-int opcode_BMI(int cycle, addressing_mode_t address_mode)
+static int step_fetch_adl(void)
 {
-    static uint8_t condition, offset = 0;
-    static uint16_t addr = 0;
-    uint8_t compliment = 0;
-
-    condition = mos6507_get_status_flag(MOS6507_STATUS_FLAG_NEGATIVE);
-
-    CALC_BRANCH()
-
-    mos6507_set_address_bus(mos6507_get_PC());
-    return 0;
+    fetch_operand(&latch.adl);
+    return -1;
 }
 
-int opcode_BNE(int cycle, addressing_mode_t address_mode)
+static int step_fetch_adh(void)
 {
-    static uint8_t condition, offset = 0;
-    static uint16_t addr = 0;
-    uint8_t compliment = 0;
-
-    condition = !mos6507_get_status_flag(MOS6507_STATUS_FLAG_ZERO);
-
-    CALC_BRANCH()
-
-    mos6507_set_address_bus(mos6507_get_PC());
-    return 0;
+    fetch_operand(&latch.adh);
+    return -1;
 }
 
-int opcode_BPL(int cycle, addressing_mode_t address_mode)
+static int step_fetch_bal(void)
 {
-    static uint8_t condition, offset = 0;
-    static uint16_t addr = 0;
-    uint8_t compliment = 0;
-
-    condition = !mos6507_get_status_flag(MOS6507_STATUS_FLAG_NEGATIVE);
-
-    CALC_BRANCH()
-
-    mos6507_set_address_bus(mos6507_get_PC());
-    return 0;
+    fetch_operand(&latch.bal);
+    return -1;
 }
 
-int opcode_BRK(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t adl, adh, pcl, pch, S, P = 0;
-
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_increment_PC();
-            return -1;
-        case 2:
-            pch = (uint8_t)(mos6507_get_PC() >> 8);
-            mos6507_push_stack(pch);
-            return -1;
-        case 3:
-            pcl = (uint8_t)mos6507_get_PC();
-            mos6507_push_stack(pcl);
-            return -1;
-        case 4:
-            mos6507_get_register(MOS6507_REG_P, &P);
-            mos6507_push_stack(P);
-            return -1;
-        case 5:
-            mos6507_set_address_bus(0xFFFE);
-            memmap_read(&adl);
-            return -1;
-        case 6:
-            mos6507_set_address_bus(0xFFFF);
-            memmap_read(&adh);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
-
-    mos6507_set_PC_hl(adh, adl);
-    mos6507_set_address_bus(mos6507_get_PC());
+static int step_fetch_bah(void)
+{
+    fetch_operand(&latch.bah);
+    return -1;
+}
 
-    return 0;
+static int step_fetch_ial(void)
+{
+    fetch_operand(&latch.ial);
+    return -1;
 }
 
-int opcode_BVC(int cycle, addressing_mode_t address_mode)
+static int step_zero_page_base(void)
 {
-    static uint8_t condition, offset = 0;
-    static uint16_t addr = 0;
-    uint8_t compliment = 0;
+    latch.addr = latch.bal;
+    return -1;
+}
 
-    condition = !mos6507_get_status_flag(MOS6507_STATUS_FLAG_OVERFLOW);
+static int step_fetch_indirect_adl(void)
+{
+    index_zero_page(MOS6507_REG_X);
+    latch.adl = memmap_bus_read(latch.addr);
+    return -1;
+}
 
-    CALC_BRANCH()
+static int step_fetch_indirect_adh(void)
+{
+    uint8_t X;
 
-    mos6507_set_address_bus(mos6507_get_PC());
-    return 0;
+    mos6507_get_register(MOS6507_REG_X, &X);
+    latch.adh = memmap_bus_read((uint8_t)((latch.bal + X) + 1));
+    return -1;
 }
 
-int opcode_BVS(int cycle, addressing_mode_t address_mode)
+static int step_fetch_indirect_bal(void)
 {
-    static uint8_t condition, offset = 0;
-    static uint16_t addr = 0;
-    uint8_t compliment = 0;
-
-    condition = mos6507_get_status_flag(MOS6507_STATUS_FLAG_OVERFLOW);
+    latch.bal = memmap_bus_read(latch.ial);
+    return -1;
+}
 
-    CALC_BRANCH()
+static int step_fetch_indirect_bah(void)
+{
+    latch.bah = memmap_bus_read((uint8_t)(latch.ial+1));
+    return -1;
+}
 
+static int step_read_immediate(operation_t operation)
+{
+    fetch_operand(&latch.data);
+    operation(&latch.data);
     END_OPCODE()
     return 0;
 }
 
-int opcode_CLC(int cycle, addressing_mode_t address_mode)
+static int step_read_zero_page(operation_t operation)
 {
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, 0);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
+    latch.addr = latch.adl;
+    return read_data(operation);
+}
 
-    END_OPCODE()
-    return 0;
+static int step_read_zero_page_x(operation_t operation)
+{
+    index_zero_page(MOS6507_REG_X);
+    return read_data(operation);
 }
 
-int opcode_CLD(int cycle, addressing_mode_t address_mode)
+static int step_read_zero_page_y(operation_t operation)
 {
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_DECIMAL, 0);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
+    index_zero_page(MOS6507_REG_Y);
+    return read_data(operation);
+}
 
-    END_OPCODE()
-    return 0;
+static int step_read_absolute(operation_t operation)
+{
+    latch.addr = (latch.adh << 8) | latch.adl;
+    return read_data(operation);
 }
 
-int opcode_CLI(int cycle, addressing_mode_t address_mode)
+/* Crossing a page boundary costs an extra cycle to fix up ADH, in
+ * which case the read is repeated by step_read_absolute().
+ */
+static int step_read_absolute_x(operation_t operation)
 {
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_INTERRUPT, 0);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
+    if (index_base_address(MOS6507_REG_X)) {
+        latch.data = memmap_bus_read(latch.addr);
+        return -1;
     }
-
-    END_OPCODE()
-    return 0;
+    return read_data(operation);
 }
 
-int opcode_CLV(int cycle, addressing_mode_t address_mode)
+static int step_read_absolute_y(operation_t operation)
 {
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_OVERFLOW, 0);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
+    if (index_base_address(MOS6507_REG_Y)) {
+        latch.data = memmap_bus_read(latch.addr);
+        return -1;
     }
-
-    END_OPCODE()
-    return 0;
+    return read_data(operation);
 }
 
-int opcode_CMP(int cycle, addressing_mode_t address_mode)
+static int step_write_zero_page(operation_t operation)
 {
-    static uint8_t adl, adh, ial, bal, bah, data = 0;
-    uint8_t X, Y, c = 0;
-
-    FETCH_DATA()
-    mos6507_CMP(data);
-    END_OPCODE()
-    return 0;
+    latch.addr = latch.adl;
+    return write_data(operation);
 }
 
-int opcode_CPX(int cycle, addressing_mode_t address_mode)
+static int step_write_zero_page_x(operation_t operation)
 {
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
-
-    FETCH_DATA()
-    mos6507_CPX(data);
-    END_OPCODE()
-    return 0;
+    index_zero_page(MOS6507_REG_X);
+    return write_data(operation);
 }
 
-int opcode_CPY(int cycle, addressing_mode_t address_mode)
+static int step_write_zero_page_y(operation_t operation)
 {
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
-
-    FETCH_DATA()
-    mos6507_CPY(data);
-    END_OPCODE()
-    return 0;
+    index_zero_page(MOS6507_REG_Y);
+    return write_data(operation);
 }
 
-int opcode_DEC(int cycle, addressing_mode_t address_mode)
+static int step_write_absolute(operation_t operation)
 {
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
-
-    FETCH_DATA();
-    data--;
-    mos6507_set_data_bus(data);
-    memmap_write();
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(data & 0xFF));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (data & 0x80));
-    END_OPCODE()
-    return 0;
+    latch.addr = (latch.adh << 8) | latch.adl;
+    return write_data(operation);
 }
 
-int opcode_DEX(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t value = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_get_register(MOS6507_REG_X, &value);
-            value--;
-            mos6507_set_register(MOS6507_REG_X, value);
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(value & 0xFF));
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (value & 0x80));
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
+static int step_write_absolute_x(operation_t operation)
+{
+    int c = index_base_address(MOS6507_REG_X);
+    latch.data = memmap_bus_read(latch.addr);
+    if (c) {
+        return -1;
     }
-
-    END_OPCODE()
-    return 0;
+    return write_data(operation);
 }
 
-int opcode_DEY(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t value = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_get_register(MOS6507_REG_Y, &value);
-            value--;
-            mos6507_set_register(MOS6507_REG_Y, value);
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(value & 0xFF));
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (value & 0x80));
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
+static int step_write_absolute_y(operation_t operation)
+{
+    int c = index_base_address(MOS6507_REG_Y);
+    latch.data = memmap_bus_read(latch.addr);
+    if (c) {
+        return -1;
     }
-
-    END_OPCODE()
-    return 0;
+    return write_data(operation);
 }
 
-int opcode_EOR(int cycle, addressing_mode_t address_mode)
+static int step_modify_zero_page(operation_t operation)
 {
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
-
-    FETCH_DATA()
-    mos6507_EOR(data);
-    END_OPCODE()
-    return 0;
+    latch.addr = latch.adl;
+    return modify_data(operation);
 }
 
-int opcode_INC(int cycle, addressing_mode_t address_mode)
+static int step_modify_zero_page_x(operation_t operation)
 {
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
-
-    FETCH_DATA();
-    data++;
-    mos6507_set_data_bus(data);
-    memmap_write();
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(data & 0xFF));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (data & 0x80));
-    END_OPCODE()
-    return 0;
+    index_zero_page(MOS6507_REG_X);
+    return modify_data(operation);
 }
 
-int opcode_INX(int cycle, addressing_mode_t address_mode)
-{
-    uint8_t value = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_get_register(MOS6507_REG_X, &value);
-            value++;
-            mos6507_set_register(MOS6507_REG_X, value);
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(value & 0xFF));
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (value & 0x80));
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
-
-    END_OPCODE()
-    return 0;
+static int step_modify_absolute(operation_t operation)
+{
+    latch.addr = (latch.adh << 8) | latch.adl;
+    return modify_data(operation);
 }
 
-int opcode_INY(int cycle, addressing_mode_t address_mode)
-{
-    uint8_t value = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_get_register(MOS6507_REG_Y, &value);
-            value++;
-            mos6507_set_register(MOS6507_REG_Y, value);
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(value & 0xFF));
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (value & 0x80));
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
+static int step_modify_absolute_x(operation_t operation)
+{
+    if (index_base_address(MOS6507_REG_X)) {
+        latch.data = memmap_bus_read(latch.addr);
+        return -1;
     }
-
-    END_OPCODE()
-    return 0;
+    return modify_data(operation);
 }
 
-int opcode_JMP(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t adl, adh = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_increment_PC();
-            mos6507_set_address_bus(mos6507_get_PC());
-            memmap_read(&adl);
-            return -1;
-        case 2:
-            mos6507_increment_PC();
-            mos6507_set_address_bus(mos6507_get_PC());
-            memmap_read(&adh);
-            return -1;
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
+#ifdef SKIP_IDLE_LOOPS
+/* Recognises a taken branch as the end of a delay loop which only counts
+ * an index register, i.e.:
+ *
+ *     loop: DEX        (or DEY, INX, INY)
+ *           BNE loop   (or BPL, BMI)
+ *
+ * and skips the iterations which would branch back again, leaving the
+ * register at the value the final iteration starts from. The loop touches
+ * nothing but the register and flags, and the final iteration is run for
+ * real, so the flags end up as if every iteration had run too.
+ */
+static void skip_delay_loop(void)
+{
+    const decoded_instruction_t *target;
+    mos6507_register_t reg;
+    uint8_t branch, counter, value, final, taken;
+    uint32_t period, iterations;
+
+    /* The branch must be from the cartridge, back to the instruction
+     * immediately before it.
+     */
+    if (!decoded || latch.data != 0xFD) {
+        return;
+    }
+    target = decode_cache_lookup(decoded_PC - 1);
+    if (!target) {
+        return;
+    }
+    counter = (uint8_t)(target->instruction - instruction_table);
+    switch (counter) {
+        case 0xCA: /* DEX */
+        case 0xE8: /* INX */
+            reg = MOS6507_REG_X;
+            break;
+        case 0x88: /* DEY */
+        case 0xC8: /* INY */
+            reg = MOS6507_REG_Y;
             break;
+        default:
+            return;
     }
 
-    mos6507_set_PC_hl(adh, adl);
-    mos6507_set_address_bus_hl(adh, adl);
-    return 0;
-}
-
-int opcode_JSR(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t adl, adh, pcl, pch, S = 0;
-    uint16_t address = 0;
-
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_increment_PC();
-            mos6507_set_address_bus(mos6507_get_PC());
-            memmap_read(&adl);
-            return -1;
-        case 2:
-            mos6507_get_register(MOS6507_REG_S, &S);
-            mos6507_set_address_bus_hl(STACK_PAGE, S);
-            return -1;
-        case 3:
-            pch = (uint8_t)(mos6507_get_PC() >> 8);
-            mos6507_push_stack(pch);
-            return -1;
-        case 4:
-            pcl = (uint8_t)mos6507_get_PC();
-            mos6507_push_stack(pcl);
-            return -1;
-        case 5:
-            mos6507_increment_PC();
-            mos6507_set_address_bus(mos6507_get_PC());
-            memmap_read(&adh);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
+    /* The register value from which one more step leaves the loop, and
+     * whether the loop would be continuing from the current value. The
+     * flags needn't have come from the register, e.g., when jumping
+     * straight to the branch, so it is checked directly.
+     */
+    mos6507_get_register(reg, &value);
+    branch = (uint8_t)(decoded->instruction - instruction_table);
+    switch (branch) {
+        case 0xD0: /* BNE, until zero */
+            final = (counter == 0xCA || counter == 0x88) ? 0x01 : 0xFF;
+            taken = (value != 0);
+            break;
+        case 0x10: /* BPL, until negative */
+            final = (counter == 0xCA || counter == 0x88) ? 0x00 : 0x7F;
+            taken = !(value & 0x80);
             break;
+        case 0x30: /* BMI, until positive */
+            final = (counter == 0xCA || counter == 0x88) ? 0x80 : 0xFF;
+            taken = (value & 0x80) ? 1 : 0;
+            break;
+        default:
+            return;
+    }
+    if (!taken) {
+        return;
     }
-    mos6507_set_address_bus_hl(adh, adl);
-    mos6507_set_PC_hl(adh, adl);
-
-    return 0;
-}
-
-int opcode_LDA(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
-
-    FETCH_DATA()
-
-    mos6507_set_register(MOS6507_REG_A, data);
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(data & 0xFF));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (data & 0x80));
-    END_OPCODE()
-    return 0;
-}
-
-int opcode_LDX(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
-
-    FETCH_DATA()
-    mos6507_set_register(MOS6507_REG_X, data);
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(data & 0xFF));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (data & 0x80));
-    END_OPCODE()
-    return 0;
-}
 
-int opcode_LDY(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
+    /* Each iteration steps the register one closer to the final value */
+    if (counter == 0xCA || counter == 0x88) {
+        iterations = (uint8_t)(value - final);
+    } else {
+        iterations = (uint8_t)(final - value);
+    }
+    if (!iterations) {
+        return;
+    }
 
-    FETCH_DATA()
-    mos6507_set_register(MOS6507_REG_Y, data);
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(data & 0xFF));
-    mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (data & 0x80));
-    END_OPCODE()
-    return 0;
+    /* Counter, taken branch and a cycle more if the branch crosses a page */
+    period = 2 + 3 + (NOT_SAME_PAGE(decoded_PC + 2, decoded_PC - 1) ? 1 : 0);
+    mos6507_set_register(reg, final);
+    memmap_fast_forward(iterations * period);
 }
+#endif /* SKIP_IDLE_LOOPS */
 
-int opcode_LSR(int cycle, addressing_mode_t address_mode)
+/* Branches finish early when not taken, or when the
+ * target lies on the same page as the next instruction.
+ */
+static int step_branch_offset(operation_t operation)
 {
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
+    uint8_t condition;
 
-    if (OPCODE_ADDRESSING_MODE_ACCUMULATOR == address_mode) {
-        switch(cycle) {
-            case 0:
-                /* Consume clock cycle for fetching op-code */
-                return -1;
-            case 1:
-                mos6507_LSR_Accumulator();
-                /* Intentional fall-through */
-            default:
-                /* End of op-code execution */
-                break;
-        }
+    fetch_operand(&latch.data);
+    operation(&condition);
+    if (!condition) {
         END_OPCODE()
         return 0;
     }
-
-    FETCH_DATA()
-    mos6507_LSR(&data);
-    END_OPCODE()
-    return 0;
+#ifdef SKIP_IDLE_LOOPS
+    skip_delay_loop();
+#endif
+    return -1;
 }
 
-int opcode_NOP(int cycle, addressing_mode_t address_mode)
+static int step_branch_target(void)
 {
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1: ;
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
+    /* The offset is signed, from -128 to +127 */
+    mos6507_increment_PC();
+    latch.addr = mos6507_get_PC() + (int8_t)latch.data;
+    if (NOT_SAME_PAGE(mos6507_get_PC(), latch.addr)) {
+        return -1;
     }
-    END_OPCODE()
+    mos6507_set_PC(latch.addr);
     return 0;
 }
 
-
-int opcode_ORA(int cycle, addressing_mode_t address_mode)
+static int step_branch_page_cross(void)
 {
-    static uint8_t adl, adh, ial, bal, bah, data = 0;
-    uint8_t X, Y, c = 0;
-
-    FETCH_DATA()
-    mos6507_ORA(&data);
-    END_OPCODE()
+    mos6507_set_PC(latch.addr);
     return 0;
 }
 
-int opcode_PHA(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t value, S = 0;
-
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            /* Consume another clock cycle incrementing PC */
-            mos6507_increment_PC();
-            mos6507_set_address_bus(mos6507_get_PC());
-            return -1;
-        case 2:
-            /* Fetch value of Accumulator register and stack pointer */
-            mos6507_get_register(MOS6507_REG_A, &value);
-            mos6507_push_stack(value);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
-    mos6507_set_address_bus(mos6507_get_PC());
+/* Stack and control flow steps */
 
-    return 0;
+static int step_increment_PC(void)
+{
+    /* Consume another clock cycle incrementing PC */
+    mos6507_increment_PC();
+    return -1;
 }
 
-int opcode_PHP(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t value, S= 0;
-
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            /* Consume another clock cycle incrementing PC */
-            mos6507_increment_PC();
-            mos6507_set_address_bus(mos6507_get_PC());
-            return -1;
-        case 2:
-            /* Fetch value of status register and stack pointer */
-            mos6507_get_register(MOS6507_REG_P, &value);
-            mos6507_push_stack(value);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
-
-    mos6507_set_address_bus(mos6507_get_PC());
-    return 0;
+static int step_skip_padding(void)
+{
+    /* BRK is followed by a padding byte, which its return address skips */
+    mos6507_increment_PC();
+    mos6507_increment_PC();
+    return -1;
 }
 
-int opcode_PLA(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t value, source = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            /* Consume another clock cycle incrementing PC */
-            mos6507_increment_PC();
-            mos6507_set_address_bus(mos6507_get_PC());
-            return -1;
-        case 2:
-            mos6507_get_register(MOS6507_REG_S, &source);
-            mos6507_set_address_bus_hl(STACK_PAGE, source);
-            return -1;
-        case 3:
-            mos6507_pull_stack(&value);
-            mos6507_set_register(MOS6507_REG_A, value);
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (value & 0x80));
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(value & 0xFF));
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
-
-    mos6507_set_address_bus(mos6507_get_PC());
-    return 0;
+static int step_stack_address(void)
+{
+    /* Consume clock cycle addressing the stack */
+    return -1;
 }
 
-int opcode_PLP(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t value, source = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            /* Consume another clock cycle incrementing PC */
-            mos6507_increment_PC();
-            mos6507_set_address_bus(mos6507_get_PC());
-            return -1;
-        case 2:
-            mos6507_get_register(MOS6507_REG_S, &source);
-            mos6507_set_address_bus_hl(STACK_PAGE, source);
-            return -1;
-        case 3:
-            mos6507_pull_stack(&value);
-            mos6507_set_register(MOS6507_REG_P, value);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
-
-    mos6507_set_address_bus(mos6507_get_PC());
+static int step_push(operation_t operation)
+{
+    operation(&latch.data);
+    mos6507_push_stack(latch.data);
     return 0;
 }
 
-int opcode_ROL(int cycle, addressing_mode_t address_mode)
+static int step_pull(operation_t operation)
 {
-    static uint8_t adl, adh, ial, bal, bah, data = 0;
-    uint8_t X, Y, c = 0;
-
-    if (OPCODE_ADDRESSING_MODE_ACCUMULATOR == address_mode) {
-        switch(cycle) {
-            case 0:
-                /* Consume clock cycle for fetching op-code */
-                return -1;
-            case 1:
-                mos6507_ROL_Accumulator();
-                /* Intentional fall-through */
-            default:
-                /* End of op-code execution */
-                break;
-        }
-        END_OPCODE()
-        return 0;
-    }
-
-    FETCH_DATA()
-    mos6507_ROL(&data);
-    END_OPCODE()
+    mos6507_pull_stack(&latch.data);
+    operation(&latch.data);
     return 0;
 }
 
-int opcode_ROR(int cycle, addressing_mode_t address_mode)
+static int step_push_pch(void)
 {
-    static uint8_t adl, adh, ial, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
-
-    if (OPCODE_ADDRESSING_MODE_ACCUMULATOR == address_mode) {
-        switch(cycle) {
-            case 0:
-                /* Consume clock cycle for fetching op-code */
-                return -1;
-            case 1:
-                mos6507_ROR_Accumulator();
-                /* Intentional fall-through */
-            default:
-                /* End of op-code execution */
-                break;
-        }
-        END_OPCODE()
-        return 0;
-    }
-
-    FETCH_DATA()
-    mos6507_ROR(&data);
-    END_OPCODE()
-    return 0;
+    mos6507_push_stack((uint8_t)(mos6507_get_PC() >> 8));
+    return -1;
 }
 
-int opcode_RTI(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t pcl, pch, S, nuS = 0;
-
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_increment_PC();
-            mos6507_set_address_bus(mos6507_get_PC());
-            return -1;
-        case 2:
-            mos6507_get_register(MOS6507_REG_S, &S);
-            mos6507_set_address_bus_hl(STACK_PAGE, S);
-            return -1;
-        case 3:
-            mos6507_pull_stack(&nuS);
-            mos6507_set_register(MOS6507_REG_S, nuS);
-            return -1;
-        case 4:
-            mos6507_pull_stack(&pcl);
-            return -1;
-        case 5:
-            mos6507_pull_stack(&pch);
-            mos6507_set_PC_hl(pch, pcl);
-            mos6507_set_address_bus_hl(pch, pcl);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
-    return 0;
+static int step_push_pcl(void)
+{
+    mos6507_push_stack((uint8_t)mos6507_get_PC());
+    return -1;
 }
 
-int opcode_RTS(int cycle, addressing_mode_t address_mode)
-{
-    static uint8_t pcl, pch, S = 0;
-
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_increment_PC();
-            mos6507_set_address_bus(mos6507_get_PC());
-            return -1;
-        case 2:
-            mos6507_get_register(MOS6507_REG_S, &S);
-            mos6507_set_address_bus_hl(STACK_PAGE, S);
-            return -1;
-        case 3:
-            mos6507_pull_stack(&pcl);
-            return -1;
-        case 4:
-            mos6507_pull_stack(&pch);
-            return -1;
-        case 5:
-            mos6507_set_PC_hl(pch, pcl);
-            mos6507_set_address_bus_hl(pch, pcl);
-            // TODO: Review if this is actually necessary for maintaining 
-            // subroutine consistency
-            mos6507_increment_PC();
-            mos6507_set_address_bus(mos6507_get_PC());
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
-
-    END_OPCODE()
-    return 0;
+static int step_push_status(void)
+{
+    uint8_t P;
+
+    /* Pushed with the break flag set, then further interrupts are
+     * disabled while the handler runs
+     */
+    mos6507_get_register(MOS6507_REG_P, &P);
+    mos6507_push_stack(P | MOS6507_STATUS_FLAG_BREAK);
+    mos6507_set_status_flag(MOS6507_STATUS_FLAG_INTERRUPT, 1);
+    return -1;
 }
 
-int opcode_SBC(int cycle, addressing_mode_t address_mode)
+static int step_pull_status(void)
 {
-    static uint8_t adl, adh, ial, bal, bah, data = 0;
-    uint8_t X, Y, c = 0;
+    uint8_t P;
 
-    FETCH_DATA()
-    mos6507_SBC(data);
-    END_OPCODE()
-    return 0;
+    mos6507_pull_stack(&P);
+    mos6507_set_register(MOS6507_REG_P, P);
+    return -1;
 }
 
-int opcode_SEC(int cycle, addressing_mode_t address_mode)
+static int step_pull_pcl(void)
 {
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, 1);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
-
-    END_OPCODE()
-    return 0;
+    mos6507_pull_stack(&latch.adl);
+    return -1;
 }
 
-int opcode_SED(int cycle, addressing_mode_t address_mode)
+static int step_pull_pch(void)
 {
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_DECIMAL, 1);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
-
-    END_OPCODE()
-    return 0;
+    mos6507_pull_stack(&latch.adh);
+    return -1;
 }
 
-int opcode_SEI(int cycle, addressing_mode_t address_mode)
+static int step_jump(void)
 {
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_INTERRUPT, 1);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
-
-    END_OPCODE()
+    mos6507_set_PC_hl(latch.adh, latch.adl);
     return 0;
 }
 
-int opcode_STA(int cycle, addressing_mode_t address_mode)
+static int step_jump_subroutine(void)
 {
-    static uint8_t adl, adh, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
+    fetch_operand(&latch.adh);
+    return step_jump();
+}
 
-    FETCH_STORE_ADDRESS()
-    mos6507_get_register(MOS6507_REG_A, &data);
-    mos6507_set_data_bus(data);
-    memmap_write();
+static int step_return_subroutine(void)
+{
+    mos6507_set_PC_hl(latch.adh, latch.adl);
+    // TODO: Review if this is actually necessary for maintaining
+    // subroutine consistency
+    mos6507_increment_PC();
     END_OPCODE()
     return 0;
 }
 
-int opcode_STX(int cycle, addressing_mode_t address_mode)
+static int step_return_interrupt(void)
 {
-    static uint8_t adl, adh, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
-
-    FETCH_STORE_ADDRESS()
-    mos6507_get_register(MOS6507_REG_X, &data);
-    mos6507_set_data_bus(data);
-    memmap_write();
-    END_OPCODE()
-    return 0;
+    mos6507_pull_stack(&latch.adh);
+    return step_jump();
 }
 
-int opcode_STY(int cycle, addressing_mode_t address_mode)
+static int step_fetch_vector_adl(void)
 {
-    static uint8_t adl, adh, bah, bal, data = 0;
-    uint8_t X, Y, c = 0;
+    latch.adl = memmap_bus_read(0xFFFE);
+    return -1;
+}
 
-    FETCH_STORE_ADDRESS()
-    mos6507_get_register(MOS6507_REG_Y, &data);
-    mos6507_set_data_bus(data);
-    memmap_write();
-    END_OPCODE()
-    return 0;
+static int step_fetch_vector_adh(void)
+{
+    latch.adh = memmap_bus_read(0xFFFF);
+    return step_jump();
 }
 
-int opcode_TAX(int cycle, addressing_mode_t address_mode)
+/******************************************************************************
+ * Instruction set implementation
+ *
+ * These functions implement the logical instruction (e.g., ADD, ROR,
+ * MOV etc) independent of the clock steps and memory access methods which
+ * make the emulation cycle accurate. Where possible they defer to
+ * mos6507-microcode.c which has no knowledge of the memory map beyond what
+ * is actually present in the CPU itself.
+ *****************************************************************************/
+
+/* Transfers the contents of one register to another */
+static void transfer(mos6507_register_t from, mos6507_register_t to)
 {
-    uint8_t value = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_get_register(MOS6507_REG_A, &value);
-            mos6507_set_register(MOS6507_REG_X, value);
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(value & 0xFF));
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (value & 0x80));
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
+    uint8_t value;
 
-    END_OPCODE()
-    return 0;
+    mos6507_get_register(from, &value);
+    mos6507_set_register(to, value);
+    mos6507_set_NZ(value);
 }
 
-int opcode_TAY(int cycle, addressing_mode_t address_mode)
+/* Load and store */
+void op_LDA(uint8_t *data) { mos6507_set_register(MOS6507_REG_A, *data); mos6507_set_NZ(*data); }
+void op_LDX(uint8_t *data) { mos6507_set_register(MOS6507_REG_X, *data); mos6507_set_NZ(*data); }
+void op_LDY(uint8_t *data) { mos6507_set_register(MOS6507_REG_Y, *data); mos6507_set_NZ(*data); }
+void op_STA(uint8_t *data) { mos6507_get_register(MOS6507_REG_A, data); }
+void op_STX(uint8_t *data) { mos6507_get_register(MOS6507_REG_X, data); }
+void op_STY(uint8_t *data) { mos6507_get_register(MOS6507_REG_Y, data); }
+
+/* Arithmetic */
+void op_ADC(uint8_t *data) { mos6507_ADC(*data); }
+void op_SBC(uint8_t *data) { mos6507_SBC(*data); }
+
+/* Increment and decrement */
+void op_INC(uint8_t *data) { (*data)++; mos6507_set_NZ(*data); }
+void op_DEC(uint8_t *data) { (*data)--; mos6507_set_NZ(*data); }
+
+void op_INX(uint8_t *data)
 {
-    uint8_t value = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_get_register(MOS6507_REG_A, &value);
-            mos6507_set_register(MOS6507_REG_Y, value);
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(value & 0xFF));
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (value & 0x80));
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
+    uint8_t value;
 
-    END_OPCODE()
-    return 0;
+    mos6507_get_register(MOS6507_REG_X, &value);
+    value++;
+    mos6507_set_register(MOS6507_REG_X, value);
+    mos6507_set_NZ(value);
 }
 
-int opcode_TSX(int cycle, addressing_mode_t address_mode)
+void op_INY(uint8_t *data)
 {
-    uint8_t value = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_get_register(MOS6507_REG_S, &value);
-            mos6507_set_register(MOS6507_REG_X, value);
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(value & 0xFF));
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (value & 0x80));
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
+    uint8_t value;
 
-    END_OPCODE()
-    return 0;
+    mos6507_get_register(MOS6507_REG_Y, &value);
+    value++;
+    mos6507_set_register(MOS6507_REG_Y, value);
+    mos6507_set_NZ(value);
 }
 
-int opcode_TXA(int cycle, addressing_mode_t address_mode)
+void op_DEX(uint8_t *data)
 {
-    uint8_t value = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_get_register(MOS6507_REG_X, &value);
-            mos6507_set_register(MOS6507_REG_A, value);
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(value & 0xFF));
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (value & 0x80));
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
+    uint8_t value;
 
-    END_OPCODE()
-    return 0;
+    mos6507_get_register(MOS6507_REG_X, &value);
+    value--;
+    mos6507_set_register(MOS6507_REG_X, value);
+    mos6507_set_NZ(value);
 }
 
-int opcode_TXS(int cycle, addressing_mode_t address_mode)
+void op_DEY(uint8_t *data)
 {
-    uint8_t value = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_get_register(MOS6507_REG_X, &value);
-            mos6507_set_register(MOS6507_REG_S, value);
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
+    uint8_t value;
 
-    END_OPCODE()
-    return 0;
+    mos6507_get_register(MOS6507_REG_Y, &value);
+    value--;
+    mos6507_set_register(MOS6507_REG_Y, value);
+    mos6507_set_NZ(value);
 }
 
-int opcode_TYA(int cycle, addressing_mode_t address_mode)
+/* Logical */
+void op_AND(uint8_t *data) { mos6507_AND(*data); }
+void op_EOR(uint8_t *data) { mos6507_EOR(*data); }
+void op_ORA(uint8_t *data) { mos6507_ORA(data); }
+
+/* Branch conditions */
+void op_BCC(uint8_t *data) { *data = !mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY); }
+void op_BCS(uint8_t *data) { *data = mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY); }
+void op_BEQ(uint8_t *data) { *data = mos6507_get_status_flag(MOS6507_STATUS_FLAG_ZERO); }
+void op_BNE(uint8_t *data) { *data = !mos6507_get_status_flag(MOS6507_STATUS_FLAG_ZERO); }
+void op_BMI(uint8_t *data) { *data = mos6507_get_status_flag(MOS6507_STATUS_FLAG_NEGATIVE); }
+void op_BPL(uint8_t *data) { *data = !mos6507_get_status_flag(MOS6507_STATUS_FLAG_NEGATIVE); }
+void op_BVS(uint8_t *data) { *data = mos6507_get_status_flag(MOS6507_STATUS_FLAG_OVERFLOW); }
+void op_BVC(uint8_t *data) { *data = !mos6507_get_status_flag(MOS6507_STATUS_FLAG_OVERFLOW); }
+
+/* Compare and test */
+void op_CMP(uint8_t *data) { mos6507_CMP(*data); }
+void op_CPX(uint8_t *data) { mos6507_CPX(*data); }
+void op_CPY(uint8_t *data) { mos6507_CPY(*data); }
+void op_BIT(uint8_t *data) { mos6507_BIT(*data); }
+
+/* Shift and rotate */
+void op_ASL(uint8_t *data) { mos6507_ASL(data); }
+void op_LSR(uint8_t *data) { mos6507_LSR(data); }
+void op_ROL(uint8_t *data) { mos6507_ROL(data); }
+void op_ROR(uint8_t *data) { mos6507_ROR(data); }
+void op_ASL_A(uint8_t *data) { mos6507_ASL_Accumulator(); }
+void op_LSR_A(uint8_t *data) { mos6507_LSR_Accumulator(); }
+void op_ROL_A(uint8_t *data) { mos6507_ROL_Accumulator(); }
+void op_ROR_A(uint8_t *data) { mos6507_ROR_Accumulator(); }
+
+/* Transfer */
+void op_TAX(uint8_t *data) { transfer(MOS6507_REG_A, MOS6507_REG_X); }
+void op_TAY(uint8_t *data) { transfer(MOS6507_REG_A, MOS6507_REG_Y); }
+void op_TXA(uint8_t *data) { transfer(MOS6507_REG_X, MOS6507_REG_A); }
+void op_TYA(uint8_t *data) { transfer(MOS6507_REG_Y, MOS6507_REG_A); }
+
+/* Stack */
+void op_TSX(uint8_t *data) { transfer(MOS6507_REG_S, MOS6507_REG_X); }
+
+void op_TXS(uint8_t *data)
 {
-    uint8_t value = 0;
-    switch(cycle) {
-        case 0:
-            /* Consume clock cycle for fetching op-code */
-            return -1;
-        case 1:
-            mos6507_get_register(MOS6507_REG_Y, &value);
-            mos6507_set_register(MOS6507_REG_A, value);
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_ZERO, !(value & 0xFF));
-            mos6507_set_status_flag(MOS6507_STATUS_FLAG_NEGATIVE, (value & 0x80));
-            /* Intentional fall-through */
-        default:
-            /* End of op-code execution */
-            break;
-    }
+    uint8_t value;
 
-    END_OPCODE()
-    return 0;
+    /* Unlike the other transfers TXS leaves the status flags alone */
+    mos6507_get_register(MOS6507_REG_X, &value);
+    mos6507_set_register(MOS6507_REG_S, value);
 }
 
+void op_PHA(uint8_t *data) { mos6507_get_register(MOS6507_REG_A, data); }
+void op_PHP(uint8_t *data) { mos6507_get_register(MOS6507_REG_P, data); }
+void op_PLA(uint8_t *data) { mos6507_set_register(MOS6507_REG_A, *data); mos6507_set_NZ(*data); }
+void op_PLP(uint8_t *data) { mos6507_set_register(MOS6507_REG_P, *data); }
+
+/* Set and reset */
+void op_CLC(uint8_t *data) { mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, 0); }
+void op_CLD(uint8_t *data) { mos6507_set_status_flag(MOS6507_STATUS_FLAG_DECIMAL, 0); }
+void op_CLI(uint8_t *data) { mos6507_set_status_flag(MOS6507_STATUS_FLAG_INTERRUPT, 0); }
+void op_CLV(uint8_t *data) { mos6507_set_status_flag(MOS6507_STATUS_FLAG_OVERFLOW, 0); }
+void op_SEC(uint8_t *data) { mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, 1); }
+void op_SED(uint8_t *data) { mos6507_set_status_flag(MOS6507_STATUS_FLAG_DECIMAL, 1); }
+void op_SEI(uint8_t *data) { mos6507_set_status_flag(MOS6507_STATUS_FLAG_INTERRUPT, 1); }
+
+/* Miscellaneous */
+void op_NOP(uint8_t *data) { }
+
+/* Bind each operation into the steps of the addressing modes it is used
+ * with. Specialisations the table doesn't refer to are discarded.
+ */
+SPECIALISE_READ(op_LDA)
+SPECIALISE_READ(op_LDX)
+SPECIALISE_READ(op_LDY)
+SPECIALISE_READ(op_ADC)
+SPECIALISE_READ(op_SBC)
+SPECIALISE_READ(op_AND)
+SPECIALISE_READ(op_ORA)
+SPECIALISE_READ(op_EOR)
+SPECIALISE_READ(op_CMP)
+SPECIALISE_READ(op_CPX)
+SPECIALISE_READ(op_CPY)
+SPECIALISE_READ(op_BIT)
+SPECIALISE_WRITE(op_STA)
+SPECIALISE_WRITE(op_STX)
+SPECIALISE_WRITE(op_STY)
+SPECIALISE_MODIFY(op_INC)
+SPECIALISE_MODIFY(op_DEC)
+SPECIALISE_MODIFY(op_ASL)
+SPECIALISE_MODIFY(op_LSR)
+SPECIALISE_MODIFY(op_ROL)
+SPECIALISE_MODIFY(op_ROR)
+SPECIALISE_IMPLIED(op_INX)
+SPECIALISE_IMPLIED(op_INY)
+SPECIALISE_IMPLIED(op_DEX)
+SPECIALISE_IMPLIED(op_DEY)
+SPECIALISE_IMPLIED(op_ASL_A)
+SPECIALISE_IMPLIED(op_LSR_A)
+SPECIALISE_IMPLIED(op_ROL_A)
+SPECIALISE_IMPLIED(op_ROR_A)
+SPECIALISE_IMPLIED(op_TAX)
+SPECIALISE_IMPLIED(op_TAY)
+SPECIALISE_IMPLIED(op_TXA)
+SPECIALISE_IMPLIED(op_TYA)
+SPECIALISE_IMPLIED(op_TSX)
+SPECIALISE_IMPLIED(op_TXS)
+SPECIALISE_IMPLIED(op_CLC)
+SPECIALISE_IMPLIED(op_CLD)
+SPECIALISE_IMPLIED(op_CLI)
+SPECIALISE_IMPLIED(op_CLV)
+SPECIALISE_IMPLIED(op_SEC)
+SPECIALISE_IMPLIED(op_SED)
+SPECIALISE_IMPLIED(op_SEI)
+SPECIALISE_IMPLIED(op_NOP)
+SPECIALISE_RELATIVE(op_BCC)
+SPECIALISE_RELATIVE(op_BCS)
+SPECIALISE_RELATIVE(op_BEQ)
+SPECIALISE_RELATIVE(op_BNE)
+SPECIALISE_RELATIVE(op_BMI)
+SPECIALISE_RELATIVE(op_BPL)
+SPECIALISE_RELATIVE(op_BVS)
+SPECIALISE_RELATIVE(op_BVC)
+SPECIALISE_PUSH(op_PHA)
+SPECIALISE_PUSH(op_PHP)
+SPECIALISE_PULL(op_PLA)
+SPECIALISE_PULL(op_PLP)
+
+/******************************************************************************
+ * Instruction table
+ *
+ * Maps each op-code to its length, base cycle count, addressing mode and the
+ * micro-op run on each of its clock cycles. E.g., LDA immediate is 0xA9 so row 0xA9 is two
+ * bytes long and holds the op-code fetch followed by an immediate read which
+ * loads the Accumulator. Op-codes with no entry are illegal.
+ *****************************************************************************/
+
+const instruction_t instruction_table[ISA_LENGTH] = {
+
+    /* 0x00: BRK, Implied */
+    [0x00] = { 1, 7, ADDRESSING_CONTROL, {
+        step_fetch_opcode,
+        step_skip_padding,
+        step_push_pch,
+        step_push_pcl,
+        step_push_status,
+        step_fetch_vector_adl,
+        step_fetch_vector_adh
+    } },
+
+    /* Load accumulator with memory */
+    [0xA9] = READ_IMMEDIATE(op_LDA),
+    [0xA5] = READ_ZERO_PAGE(op_LDA),
+    [0xB5] = READ_ZERO_PAGE_X_INDEXED(op_LDA),
+    [0xAD] = READ_ABSOLUTE(op_LDA),
+    [0xBD] = READ_ABSOLUTE_X_INDEXED(op_LDA),
+    [0xB9] = READ_ABSOLUTE_Y_INDEXED(op_LDA),
+    [0xA1] = READ_INDIRECT_X_INDEXED(op_LDA),
+    [0xB1] = READ_INDIRECT_Y_INDEXED(op_LDA),
+
+    /* Load Index X with memory */
+    [0xA2] = READ_IMMEDIATE(op_LDX),
+    [0xA6] = READ_ZERO_PAGE(op_LDX),
+    [0xB6] = READ_ZERO_PAGE_Y_INDEXED(op_LDX),
+    [0xAE] = READ_ABSOLUTE(op_LDX),
+    [0xBE] = READ_ABSOLUTE_Y_INDEXED(op_LDX),
+
+    /* Load Index Y with memory */
+    [0xA0] = READ_IMMEDIATE(op_LDY),
+    [0xA4] = READ_ZERO_PAGE(op_LDY),
+    [0xB4] = READ_ZERO_PAGE_X_INDEXED(op_LDY),
+    [0xAC] = READ_ABSOLUTE(op_LDY),
+    [0xBC] = READ_ABSOLUTE_X_INDEXED(op_LDY),
+
+    /* Store Accumulator in memory */
+    [0x85] = WRITE_ZERO_PAGE(op_STA),
+    [0x95] = WRITE_ZERO_PAGE_X_INDEXED(op_STA),
+    [0x8D] = WRITE_ABSOLUTE(op_STA),
+    [0x9D] = WRITE_ABSOLUTE_X_INDEXED(op_STA),
+    [0x99] = WRITE_ABSOLUTE_Y_INDEXED(op_STA),
+    [0x81] = WRITE_INDIRECT_X_INDEXED(op_STA),
+    [0x91] = WRITE_INDIRECT_Y_INDEXED(op_STA),
+
+    /* Store Index X in memory */
+    [0x86] = WRITE_ZERO_PAGE(op_STX),
+    [0x96] = WRITE_ZERO_PAGE_Y_INDEXED(op_STX),
+    [0x8E] = WRITE_ABSOLUTE(op_STX),
+
+    /* Store Index Y in memory */
+    [0x84] = WRITE_ZERO_PAGE(op_STY),
+    [0x94] = WRITE_ZERO_PAGE_X_INDEXED(op_STY),
+    [0x8C] = WRITE_ABSOLUTE(op_STY),
+
+    /* Add memory to Accumulator with carry */
+    [0x69] = READ_IMMEDIATE(op_ADC),
+    [0x65] = READ_ZERO_PAGE(op_ADC),
+    [0x75] = READ_ZERO_PAGE_X_INDEXED(op_ADC),
+    [0x6D] = READ_ABSOLUTE(op_ADC),
+    [0x7D] = READ_ABSOLUTE_X_INDEXED(op_ADC),
+    [0x79] = READ_ABSOLUTE_Y_INDEXED(op_ADC),
+    [0x61] = READ_INDIRECT_X_INDEXED(op_ADC),
+    [0x71] = READ_INDIRECT_Y_INDEXED(op_ADC),
+
+    /* Subtract memory from Accumulator with borrow */
+    [0xE9] = READ_IMMEDIATE(op_SBC),
+    [0xE5] = READ_ZERO_PAGE(op_SBC),
+    [0xF5] = READ_ZERO_PAGE_X_INDEXED(op_SBC),
+    [0xED] = READ_ABSOLUTE(op_SBC),
+    [0xFD] = READ_ABSOLUTE_X_INDEXED(op_SBC),
+    [0xF9] = READ_ABSOLUTE_Y_INDEXED(op_SBC),
+    [0xE1] = READ_INDIRECT_X_INDEXED(op_SBC),
+    [0xF1] = READ_INDIRECT_Y_INDEXED(op_SBC),
+
+    /* Increment memory by one */
+    [0xE6] = MODIFY_ZERO_PAGE(op_INC),
+    [0xF6] = MODIFY_ZERO_PAGE_X_INDEXED(op_INC),
+    [0xEE] = MODIFY_ABSOLUTE(op_INC),
+    [0xFE] = MODIFY_ABSOLUTE_X_INDEXED(op_INC),
+
+    /* Increment Index X by one */
+    [0xE8] = IMPLIED(op_INX),
+
+    /* Increment Index Y by one */
+    [0xC8] = IMPLIED(op_INY),
+
+    /* Decrement memory by one */
+    [0xC6] = MODIFY_ZERO_PAGE(op_DEC),
+    [0xD6] = MODIFY_ZERO_PAGE_X_INDEXED(op_DEC),
+    [0xCE] = MODIFY_ABSOLUTE(op_DEC),
+    [0xDE] = MODIFY_ABSOLUTE_X_INDEXED(op_DEC),
+
+    /* Decrement Index X by one */
+    [0xCA] = IMPLIED(op_DEX),
+
+    /* Decrement Index Y by one */
+    [0x88] = IMPLIED(op_DEY),
+
+    /* Logical AND with Accumulator */
+    [0x21] = READ_INDIRECT_X_INDEXED(op_AND),
+    [0x25] = READ_ZERO_PAGE(op_AND),
+    [0x29] = READ_IMMEDIATE(op_AND),
+    [0x2D] = READ_ABSOLUTE(op_AND),
+    [0x31] = READ_INDIRECT_Y_INDEXED(op_AND),
+    [0x35] = READ_ZERO_PAGE_X_INDEXED(op_AND),
+    [0x39] = READ_ABSOLUTE_Y_INDEXED(op_AND),
+    [0x3D] = READ_ABSOLUTE_X_INDEXED(op_AND),
+
+    /* Logical OR with Accumulator */
+    [0x01] = READ_INDIRECT_X_INDEXED(op_ORA),
+    [0x05] = READ_ZERO_PAGE(op_ORA),
+    [0x09] = READ_IMMEDIATE(op_ORA),
+    [0x0D] = READ_ABSOLUTE(op_ORA),
+    [0x11] = READ_INDIRECT_Y_INDEXED(op_ORA),
+    [0x15] = READ_ZERO_PAGE_X_INDEXED(op_ORA),
+    [0x19] = READ_ABSOLUTE_Y_INDEXED(op_ORA),
+    [0x1D] = READ_ABSOLUTE_X_INDEXED(op_ORA),
+
+    /* logical exclusive OR with Accumulator */
+    [0x41] = READ_INDIRECT_X_INDEXED(op_EOR),
+    [0x45] = READ_ZERO_PAGE(op_EOR),
+    [0x49] = READ_IMMEDIATE(op_EOR),
+    [0x4D] = READ_ABSOLUTE(op_EOR),
+    [0x51] = READ_INDIRECT_Y_INDEXED(op_EOR),
+    [0x55] = READ_ZERO_PAGE_X_INDEXED(op_EOR),
+    [0x59] = READ_ABSOLUTE_Y_INDEXED(op_EOR),
+    [0x5D] = READ_ABSOLUTE_X_INDEXED(op_EOR),
+
+    /* Jump to new location. Indirect jumps currently
+     * share the absolute implementation.
+     */
+    [0x4C] = { 3, 4, ADDRESSING_CONTROL, {
+        step_fetch_opcode,
+        step_fetch_adl,
+        step_fetch_adh,
+        step_jump
+    } },
+    [0x6C] = { 3, 4, ADDRESSING_CONTROL, {
+        step_fetch_opcode,
+        step_fetch_adl,
+        step_fetch_adh,
+        step_jump
+    } },
+
+    /* Branch on carry clear */
+    [0x90] = RELATIVE(op_BCC),
+
+    /* Branch on carry set */
+    [0xB0] = RELATIVE(op_BCS),
+
+    /* Branch on result zero */
+    [0xF0] = RELATIVE(op_BEQ),
+
+    /* Branch on result not zero */
+    [0xD0] = RELATIVE(op_BNE),
+
+    /* Branch on result minus */
+    [0x30] = RELATIVE(op_BMI),
+
+    /* Branch on result plus */
+    [0x10] = RELATIVE(op_BPL),
+
+    /* Branch on overflow set */
+    [0x70] = RELATIVE(op_BVS),
+
+    /* Branch on overflow clear */
+    [0x50] = RELATIVE(op_BVC),
+
+    /* Compare with Accumulator*/
+    [0xC9] = READ_IMMEDIATE(op_CMP),
+    [0xC5] = READ_ZERO_PAGE(op_CMP),
+    [0xD5] = READ_ZERO_PAGE_X_INDEXED(op_CMP),
+    [0xCD] = READ_ABSOLUTE(op_CMP),
+    [0xDD] = READ_ABSOLUTE_X_INDEXED(op_CMP),
+    [0xD9] = READ_ABSOLUTE_Y_INDEXED(op_CMP),
+    [0xC1] = READ_INDIRECT_X_INDEXED(op_CMP),
+    [0xD1] = READ_INDIRECT_Y_INDEXED(op_CMP),
+
+    /* Compare memory with Index X */
+    [0xE0] = READ_IMMEDIATE(op_CPX),
+    [0xE4] = READ_ZERO_PAGE(op_CPX),
+    [0xEC] = READ_ABSOLUTE(op_CPX),
+
+    /* Compare memory with Index Y */
+    [0xC0] = READ_IMMEDIATE(op_CPY),
+    [0xC4] = READ_ZERO_PAGE(op_CPY),
+    [0xCC] = READ_ABSOLUTE(op_CPY),
+
+    /* Test bits in memory with Accumulator */
+    [0x24] = READ_ZERO_PAGE(op_BIT),
+    [0x2C] = READ_ABSOLUTE(op_BIT),
+
+    /* Shift left one bit */
+    [0x0A] = IMPLIED(op_ASL_A),
+    [0x06] = MODIFY_ZERO_PAGE(op_ASL),
+    [0x16] = MODIFY_ZERO_PAGE_X_INDEXED(op_ASL),
+    [0x0E] = MODIFY_ABSOLUTE(op_ASL),
+    [0x1E] = MODIFY_ABSOLUTE_X_INDEXED(op_ASL),
+
+    /* Right shift one bit */
+    [0x4A] = IMPLIED(op_LSR_A),
+    [0x46] = MODIFY_ZERO_PAGE(op_LSR),
+    [0x56] = MODIFY_ZERO_PAGE_X_INDEXED(op_LSR),
+    [0x4E] = MODIFY_ABSOLUTE(op_LSR),
+    [0x5E] = MODIFY_ABSOLUTE_X_INDEXED(op_LSR),
+
+    /* Rotate one bit left */
+    [0x2A] = IMPLIED(op_ROL_A),
+    [0x26] = MODIFY_ZERO_PAGE(op_ROL),
+    [0x36] = MODIFY_ZERO_PAGE_X_INDEXED(op_ROL),
+    [0x2E] = MODIFY_ABSOLUTE(op_ROL),
+    [0x3E] = MODIFY_ABSOLUTE_X_INDEXED(op_ROL),
+
+    /* Rotate one bit right */
+    [0x6A] = IMPLIED(op_ROR_A),
+    [0x66] = MODIFY_ZERO_PAGE(op_ROR),
+    [0x76] = MODIFY_ZERO_PAGE_X_INDEXED(op_ROR),
+    [0x6E] = MODIFY_ABSOLUTE(op_ROR),
+    [0x7E] = MODIFY_ABSOLUTE_X_INDEXED(op_ROR),
+
+    /* Transfer Accumulator to Index X */
+    [0xAA] = IMPLIED(op_TAX),
+
+    /* Transfer Accumulator to Index Y */
+    [0xA8] = IMPLIED(op_TAY),
+
+    /* Transfer Index X to Accumulator */
+    [0x8A] = IMPLIED(op_TXA),
+
+    /* Transfer Index Y to Accumulator */
+    [0x98] = IMPLIED(op_TYA),
+
+    /* Transfer stack pointer to Index X */
+    [0xBA] = IMPLIED(op_TSX),
+
+    /* Transfer Index X to stack register */
+    [0x9A] = IMPLIED(op_TXS),
+
+    /* Push Accumulator onto stack */
+    [0x48] = PUSH(op_PHA),
+
+    /* Push processor status onto stack */
+    [0x08] = PUSH(op_PHP),
+
+    /* Pull Accumulator from stack */
+    [0x68] = PULL(op_PLA),
+
+    /* Pull processor status from stack */
+    [0x28] = PULL(op_PLP),
+
+    /* Jump to new location saving return address */
+    [0x20] = { 3, 6, ADDRESSING_CONTROL, {
+        step_fetch_opcode,
+        step_fetch_adl,
+        step_stack_address,
+        step_push_pch,
+        step_push_pcl,
+        step_jump_subroutine
+    } },
+
+    /* Return from subroutine */
+    [0x60] = { 1, 6, ADDRESSING_CONTROL, {
+        step_fetch_opcode,
+        step_increment_PC,
+        step_stack_address,
+        step_pull_pcl,
+        step_pull_pch,
+        step_return_subroutine
+    } },
+
+    /* Return from interrupt */
+    [0x40] = { 1, 6, ADDRESSING_CONTROL, {
+        step_fetch_opcode,
+        step_increment_PC,
+        step_stack_address,
+        step_pull_status,
+        step_pull_pcl,
+        step_return_interrupt
+    } },
+
+    /* Clear carry flag */
+    [0x18] = IMPLIED(op_CLC),
+
+    /* Clear decimal mode */
+    [0xD8] = IMPLIED(op_CLD),
+
+    /* Clear interrupt disable bit */
+    [0x58] = IMPLIED(op_CLI),
+
+    /* Clear overflow bit */
+    [0xB8] = IMPLIED(op_CLV),
+
+    /* Set carry flag */
+    [0x38] = IMPLIED(op_SEC),
+
+    /* Set decimal flag */
+    [0xF8] = IMPLIED(op_SED),
+
+    /* Set interrupt disable status */
+    [0x78] = IMPLIED(op_SEI),
+
+    /* No operation */
+    [0xEA] = IMPLIED(op_NOP),
+};
@@ -11,135 +11,144 @@
 
 #include <stdint.h>
 
-/* Opcodes are 8-bit, allowing for 255 unique permutations.
+/* Opcodes are 8-bit, allowing for 256 unique permutations.
  * However, many bit selections don't represent valid operations.
  */
-#define ISA_LENGTH 255
+#define ISA_LENGTH 256
 
+/* The longest instruction (BRK) takes seven clock cycles */
+#define OPCODE_MAX_CYCLES 7
+
+/* The logical part of an instruction (e.g., load, add, compare) independent
+ * of how its operand was fetched. Operates on the data latched from (or to be
+ * written to) memory.
+ */
+typedef void (*operation_t)(uint8_t *data);
+
+/* A single clock cycle of an instruction, with any operation already bound
+ * in at compile time. Returns -1 if the instruction continues on the next
+ * cycle or 0 once it has completed.
+ */
+typedef int (*step_t)(void);
+
+/* How an instruction locates its operand. Indexed and indirect modes
+ * resolve their effective address at run time, so only the others can be
+ * told ahead of time which device they will access.
+ */
 typedef enum {
-    OPCODE_ADDRESSING_MODE_ACCUMULATOR = 0,
-    OPCODE_ADDRESSING_MODE_ABSOLUTE,
-    OPCODE_ADDRESSING_MODE_ABSOLUTE_X_INDEXED,
-    OPCODE_ADDRESSING_MODE_ABSOLUTE_Y_INDEXED,
-    OPCODE_ADDRESSING_MODE_IMMEDIATE,
-    OPCODE_ADDRESSING_MODE_IMPLIED,
-    OPCODE_ADDRESSING_MODE_INDIRECT,
-    OPCODE_ADDRESSING_MODE_INDIRECT_X_INDEXED,
-    OPCODE_ADDRESSING_MODE_INDIRECT_Y_INDEXED,
-    OPCODE_ADDRESSING_MODE_RELATIVE,
-    OPCODE_ADDRESSING_MODE_ZERO_PAGE,
-    OPCODE_ADDRESSING_MODE_ZERO_PAGE_X_INDEXED,
-    OPCODE_ADDRESSING_MODE_ZERO_PAGE_Y_INDEXED,
+    ADDRESSING_IMPLIED = 0,
+    ADDRESSING_IMMEDIATE,
+    ADDRESSING_ZERO_PAGE,
+    ADDRESSING_ZERO_PAGE_INDEXED,
+    ADDRESSING_ABSOLUTE,
+    ADDRESSING_ABSOLUTE_INDEXED,
+    ADDRESSING_INDIRECT,
+    ADDRESSING_RELATIVE,
+    ADDRESSING_STACK,
+    ADDRESSING_CONTROL  /* BRK, JMP, JSR, RTS and RTI */
 } addressing_mode_t;
 
-/* Define a function pointer type */
-typedef int (*fp)(int, addressing_mode_t);
-
 typedef struct {
-    fp opcode;
-    addressing_mode_t addressing_mode;
+    uint8_t length;   /* Bytes occupied by the op-code and its operands */
+    uint8_t cycles;   /* Clock cycles taken, excluding page crossing penalties */
+    uint8_t mode;     /* Addressing mode, one of addressing_mode_t */
+    step_t steps[OPCODE_MAX_CYCLES];
 } instruction_t;
 
-extern instruction_t ISA_table[ISA_LENGTH];
+/* Every (opcode, cycle) pair resolved ahead of time to the step to run on
+ * that cycle. Illegal opcodes have a NULL first step.
+ */
+extern const instruction_t instruction_table[ISA_LENGTH];
+
+struct decoded_instruction;
 
-void opcode_populate_ISA_table(void);
-int opcode_execute(uint8_t opcode);
+void opcode_fetch(uint8_t *opcode);
+int opcode_execute(uint8_t opcode, uint8_t cycle);
+void opcode_bind(const struct decoded_instruction *instruction);
+void opcode_get_decoded(const struct decoded_instruction **instruction, uint16_t *address);
+int opcode_execute_block(const struct decoded_instruction *instructions, int count);
 int opcode_validate(uint8_t opcode);
 
-/* The following function prototypes define each possible opcodes from a
- * 6507 with nmemonic annotation in commens. An additional opcode ILL is
- * added to handle illegal codes placed into a program but has no analogue
- * in a real 6507 device.
- *
- * Annotation derived from explanations found at:
- * http://www.dwheeler.com/6502/oneelkruns/asm1step.html
+/* The operations behind each instruction, also called directly by code
+ * translated ahead of time (see host/rom2c) with the addressing already
+ * resolved. Branch operations report their condition in data.
  */
 
 /* Load and store */
-int opcode_LDA(int cycle, addressing_mode_t address_mode); /* LoaD the Accumulator */
-int opcode_LDX(int cycle, addressing_mode_t address_mode); /* LoaD the X register */
-int opcode_LDY(int cycle, addressing_mode_t address_mode); /* LoaD the Y register */
-int opcode_STA(int cycle, addressing_mode_t address_mode); /* STore the Accumulator */
-int opcode_STX(int cycle, addressing_mode_t address_mode); /* STore the X register */
-int opcode_STY(int cycle, addressing_mode_t address_mode); /* STore the Y register */
+void op_LDA(uint8_t *data);
+void op_LDX(uint8_t *data);
+void op_LDY(uint8_t *data);
+void op_STA(uint8_t *data);
+void op_STX(uint8_t *data);
+void op_STY(uint8_t *data);
 
 /* Arithmetic */
-int opcode_ADC(int cycle, addressing_mode_t address_mode); /* ADd to Accumulator with Carry */
-int opcode_SBC(int cycle, addressing_mode_t address_mode); /* SuBtract from accumulator with Carry*/
+void op_ADC(uint8_t *data);
+void op_SBC(uint8_t *data);
 
 /* Increment and decrement */
-int opcode_INC(int cycle, addressing_mode_t address_mode); /* INCrement memory by one */
-int opcode_INX(int cycle, addressing_mode_t address_mode); /* INcrement X by one */
-int opcode_INY(int cycle, addressing_mode_t address_mode); /* INcrement Y by one */
-int opcode_DEC(int cycle, addressing_mode_t address_mode); /* DECrement memory by one */
-int opcode_DEX(int cycle, addressing_mode_t address_mode); /* DEcrement X by one */
-int opcode_DEY(int cycle, addressing_mode_t address_mode); /* DEcrement Y by one */
+void op_INC(uint8_t *data);
+void op_DEC(uint8_t *data);
+void op_INX(uint8_t *data);
+void op_INY(uint8_t *data);
+void op_DEX(uint8_t *data);
+void op_DEY(uint8_t *data);
 
 /* Logical */
-int opcode_AND(int cycle, addressing_mode_t address_mode); /* AND memory with accumulator */
-int opcode_ORA(int cycle, addressing_mode_t address_mode); /* OR memory with Accumulator */
-int opcode_EOR(int cycle, addressing_mode_t address_mode); /* Exclusive-OR memory with accumulator */
-
-/* Jump, branch, compare and test */
-int opcode_JMP(int cycle, addressing_mode_t address_mode); /* JuMP to another location (GOTO) */
-int opcode_BCC(int cycle, addressing_mode_t address_mode); /* Branch on Carry Clear */
-int opcode_BCS(int cycle, addressing_mode_t address_mode); /* Branch on Carry Set */
-int opcode_BEQ(int cycle, addressing_mode_t address_mode); /* Branch on EQual to zero */
-int opcode_BNE(int cycle, addressing_mode_t address_mode); /* Branch on Not Equal to zero */
-int opcode_BMI(int cycle, addressing_mode_t address_mode); /* Branch on MInus */
-int opcode_BPL(int cycle, addressing_mode_t address_mode); /* Branch on PLus */
-int opcode_BVS(int cycle, addressing_mode_t address_mode); /* Branch on oVerflow Set */
-int opcode_BVC(int cycle, addressing_mode_t address_mode); /* Branch on oVerflow clear */
-int opcode_CMP(int cycle, addressing_mode_t address_mode); /* CoMPare memory and accumulator */
-int opcode_CPX(int cycle, addressing_mode_t address_mode); /* ComPare memory and X */
-int opcode_CPY(int cycle, addressing_mode_t address_mode); /* ComPare memory and Y*/
-int opcode_BIT(int cycle, addressing_mode_t address_mode); /* Test BITs */
+void op_AND(uint8_t *data);
+void op_EOR(uint8_t *data);
+void op_ORA(uint8_t *data);
+
+/* Branch conditions */
+void op_BCC(uint8_t *data);
+void op_BCS(uint8_t *data);
+void op_BEQ(uint8_t *data);
+void op_BNE(uint8_t *data);
+void op_BMI(uint8_t *data);
+void op_BPL(uint8_t *data);
+void op_BVS(uint8_t *data);
+void op_BVC(uint8_t *data);
+
+/* Compare and test */
+void op_CMP(uint8_t *data);
+void op_CPX(uint8_t *data);
+void op_CPY(uint8_t *data);
+void op_BIT(uint8_t *data);
 
 /* Shift and rotate */
-int opcode_ASL(int cycle, addressing_mode_t address_mode); /* Accumulator Shift Left */
-int opcode_LSR(int cycle, addressing_mode_t address_mode); /* Logical Shift Right */
-int opcode_ROL(int cycle, addressing_mode_t address_mode); /* ROtate Left */
-int opcode_ROR(int cycle, addressing_mode_t address_mode); /* ROtate Right */
+void op_ASL(uint8_t *data);
+void op_LSR(uint8_t *data);
+void op_ROL(uint8_t *data);
+void op_ROR(uint8_t *data);
+void op_ASL_A(uint8_t *data);
+void op_LSR_A(uint8_t *data);
+void op_ROL_A(uint8_t *data);
+void op_ROR_A(uint8_t *data);
 
 /* Transfer */
-int opcode_TAX(int cycle, addressing_mode_t address_mode); /* Transfer Accumulator to X */
-int opcode_TAY(int cycle, addressing_mode_t address_mode); /* Transfer Accumulator to Y */
-int opcode_TXA(int cycle, addressing_mode_t address_mode); /* Transfer X to Accumulator */
-int opcode_TYA(int cycle, addressing_mode_t address_mode); /* Transfer Y to Accumulator */
+void op_TAX(uint8_t *data);
+void op_TAY(uint8_t *data);
+void op_TXA(uint8_t *data);
+void op_TYA(uint8_t *data);
 
 /* Stack */
-int opcode_TSX(int cycle, addressing_mode_t address_mode); /* Transfer Stack pointer to X */
-int opcode_TXS(int cycle, addressing_mode_t address_mode); /* Transfer X to Stack pointer */
-int opcode_PHA(int cycle, addressing_mode_t address_mode); /* PusH Accumulator on stack */
-int opcode_PHP(int cycle, addressing_mode_t address_mode); /* PusH Processor status on stack */
-int opcode_PLA(int cycle, addressing_mode_t address_mode); /* PulL Accumulator from stack */
-int opcode_PLP(int cycle, addressing_mode_t address_mode); /* PulL Processor status from stack */
-
-/* Subroutine */
-int opcode_JSR(int cycle, addressing_mode_t address_mode); /* Jump to SubRoutine */
-int opcode_RTS(int cycle, addressing_mode_t address_mode); /* ReTurn from Subroutine */
-int opcode_RTI(int cycle, addressing_mode_t address_mode); /* ReTurn from Interrupt */
+void op_TSX(uint8_t *data);
+void op_TXS(uint8_t *data);
+void op_PHA(uint8_t *data);
+void op_PHP(uint8_t *data);
+void op_PLA(uint8_t *data);
+void op_PLP(uint8_t *data);
 
 /* Set and reset */
-int opcode_CLC(int cycle, addressing_mode_t address_mode); /* CLear Carry flag */
-int opcode_CLD(int cycle, addressing_mode_t address_mode); /* CLear Decimal mode */
-int opcode_CLI(int cycle, addressing_mode_t address_mode); /* CLear Interrupt disable */
-int opcode_CLV(int cycle, addressing_mode_t address_mode); /* CLear oVerflow flag */
-
-int opcode_SEC(int cycle, addressing_mode_t address_mode); /* SEt Carry */
-int opcode_SED(int cycle, addressing_mode_t address_mode); /* SEt Decimal mode */
-int opcode_SEI(int cycle, addressing_mode_t address_mode); /* SEt Interrupt disable */
+void op_CLC(uint8_t *data);
+void op_CLD(uint8_t *data);
+void op_CLI(uint8_t *data);
+void op_CLV(uint8_t *data);
+void op_SEC(uint8_t *data);
+void op_SED(uint8_t *data);
+void op_SEI(uint8_t *data);
 
 /* Miscellaneous */
-int opcode_NOP(int cycle, addressing_mode_t address_mode); /* No OPeration */
-int opcode_BRK(int cycle, addressing_mode_t address_mode); /* BReaK */
-
-/* This is part of the program logic rather than the 6507 model. It
- * provides a sink when illegal opcodes are invoked. Further work
- * could include fleshing out the illegal opcodes with their real-world
- * actions depending on which specific 6507 implementation is being
- * emulated?
- */
-int opcode_ILL(int cycle, addressing_mode_t address_mode); /* Illegal */
+void op_NOP(uint8_t *data);
 
 #endif /* _MOS6507_OPCODES_H */
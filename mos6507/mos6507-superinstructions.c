@@ -0,0 +1,160 @@
+/*
+ * File: mos6507-superinstructions.c
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Fuses common pairs of cartridge instructions into superinstructions.
+ *
+ * Display kernels spend most of their time in a few idioms: setting a
+ * register and storing it to the TIA (LDA #imm / STA COLUBK, LDA (zp),Y /
+ * STA GRP0, INX / STX WSYNC etc.), counting or comparing a register and
+ * branching on it (DEX / BNE, CPX #imm / BNE) and padding with NOPs to
+ * land a write on a given colour clock. Unlike threaded code these may
+ * access the TIA and RIOT, so the CPU still publishes the cycle in
+ * progress before every step and devices are caught up to the exact colour
+ * clock. What is saved is the dispatch: the pair is found once and its
+ * steps run back to back rather than each cycle being looked up through
+ * the op-code.
+ */
+
+#ifdef SUPERINSTRUCTIONS
+#ifndef ATOMIC_INSTRUCTIONS
+    #error "SUPERINSTRUCTIONS requires ATOMIC_INSTRUCTIONS"
+#endif
+
+#include "atari/Atari-memmap.h"
+#include "mos6507-superinstructions.h"
+
+static superinstruction_t superinstructions[SUPERINSTRUCTION_ENTRIES] = {0};
+
+typedef enum {
+    SUPERINSTRUCTION_NONE = 0,
+    SUPERINSTRUCTION_LOAD,    /* LDA, LDX, LDY and register transfers */
+    SUPERINSTRUCTION_STORE,   /* STA, STX, STY */
+    SUPERINSTRUCTION_COUNT,   /* DEX, DEY, INX, INY */
+    SUPERINSTRUCTION_COMPARE, /* CMP, CPX, CPY */
+    SUPERINSTRUCTION_BRANCH,  /* Conditional branches */
+    SUPERINSTRUCTION_NOP
+} superinstruction_class_t;
+
+/* Classifies an op-code by the part it may play in an idiom */
+static superinstruction_class_t superinstruction_classify(uint8_t opcode)
+{
+    switch (opcode) {
+        case 0xA9: case 0xA5: case 0xB5: case 0xAD: /* LDA */
+        case 0xBD: case 0xB9: case 0xA1: case 0xB1:
+        case 0xA2: case 0xA6: case 0xB6: case 0xAE: /* LDX */
+        case 0xBE:
+        case 0xA0: case 0xA4: case 0xB4: case 0xAC: /* LDY */
+        case 0xBC:
+        case 0xAA: case 0xA8: case 0x8A: case 0x98: /* TAX, TAY, TXA, TYA */
+            return SUPERINSTRUCTION_LOAD;
+        case 0x85: case 0x95: case 0x8D: case 0x9D: /* STA */
+        case 0x99: case 0x81: case 0x91:
+        case 0x86: case 0x96: case 0x8E:            /* STX */
+        case 0x84: case 0x94: case 0x8C:            /* STY */
+            return SUPERINSTRUCTION_STORE;
+        case 0xCA: case 0x88: case 0xE8: case 0xC8:
+            return SUPERINSTRUCTION_COUNT;
+        case 0xC9: case 0xC5: case 0xCD:            /* CMP */
+        case 0xE0: case 0xE4: case 0xEC:            /* CPX */
+        case 0xC0: case 0xC4: case 0xCC:            /* CPY */
+            return SUPERINSTRUCTION_COMPARE;
+        case 0x10: case 0x30: case 0x50: case 0x70:
+        case 0x90: case 0xB0: case 0xD0: case 0xF0:
+            return SUPERINSTRUCTION_BRANCH;
+        case 0xEA:
+            return SUPERINSTRUCTION_NOP;
+        default:
+            return SUPERINSTRUCTION_NONE;
+    }
+}
+
+/* Returns 1 if two consecutive instructions form one of the idioms */
+static int superinstruction_is_idiom(const decoded_instruction_t *first, const decoded_instruction_t *second)
+{
+    superinstruction_class_t a = superinstruction_classify(first->instruction - instruction_table);
+    superinstruction_class_t b = superinstruction_classify(second->instruction - instruction_table);
+
+    switch (a) {
+        case SUPERINSTRUCTION_LOAD:
+            return b == SUPERINSTRUCTION_STORE;
+        case SUPERINSTRUCTION_COUNT:
+            return b == SUPERINSTRUCTION_STORE || b == SUPERINSTRUCTION_BRANCH;
+        case SUPERINSTRUCTION_COMPARE:
+            return b == SUPERINSTRUCTION_BRANCH;
+        case SUPERINSTRUCTION_NOP:
+            return b == SUPERINSTRUCTION_NOP;
+        default:
+            return 0;
+    }
+}
+
+/* Decodes the pair of instructions at the start address and fuses them if
+ * they form an idiom.
+ */
+static void superinstruction_fuse(superinstruction_t *fused)
+{
+    const decoded_instruction_t *first, *second;
+    int i, j;
+
+    first = decode_cache_lookup(fused->tag);
+    if (!first) {
+        return;
+    }
+    /* Copied before the second lookup can evict it */
+    fused->instructions[0] = *first;
+    second = decode_cache_lookup(fused->tag + first->instruction->length);
+    if (!second || !superinstruction_is_idiom(&fused->instructions[0], second)) {
+        return;
+    }
+    fused->instructions[1] = *second;
+
+    fused->cycles = 0;
+    for (i=0; i<SUPERINSTRUCTION_LENGTH; i++) {
+        /* Count every step, including those for a branch being taken and
+         * crossing a page, for the worst case
+         */
+        for (j=0; j<OPCODE_MAX_CYCLES && fused->instructions[i].instruction->steps[j]; j++) {
+            fused->cycles++;
+        }
+    }
+    fused->length = SUPERINSTRUCTION_LENGTH;
+}
+
+/* Finds the superinstruction starting at an address, fusing it on first
+ * use.
+ *
+ * address: location of the first op-code, as held in the program counter
+ *
+ * Returns NULL if the instructions at the address form no idiom.
+ */
+const superinstruction_t * superinstruction_lookup(uint16_t address)
+{
+    superinstruction_t *fused;
+
+    /* Match the mirroring applied by the memory map */
+    address &= 0x1FFF;
+    if (address < MEMMAP_CART_START) {
+        return 0;
+    }
+
+    fused = &superinstructions[address % SUPERINSTRUCTION_ENTRIES];
+    if (fused->tag != address) {
+        fused->tag = address;
+        fused->length = 0;
+        superinstruction_fuse(fused);
+    }
+    return fused->length ? fused : 0;
+}
+
+void superinstruction_invalidate(void)
+{
+    int i;
+    for (i=0; i<SUPERINSTRUCTION_ENTRIES; i++) {
+        superinstructions[i].tag = 0;
+        superinstructions[i].length = 0;
+    }
+}
+
+#endif /* SUPERINSTRUCTIONS */
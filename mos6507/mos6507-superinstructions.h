@@ -0,0 +1,37 @@
+/*
+ * File: mos6507-superinstructions.h
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Fuses common pairs of cartridge instructions into superinstructions.
+ */
+
+#ifndef _MOS6507_SUPERINSTRUCTIONS_H
+#define _MOS6507_SUPERINSTRUCTIONS_H
+
+#include <stdint.h>
+#include "mos6507-decode-cache.h"
+
+/* Superinstructions are direct mapped by their start address, with room
+ * on the FE310 for the pairs of the hottest kernel loops only.
+ */
+#ifdef HOST_BUILD
+    #define SUPERINSTRUCTION_ENTRIES 1024
+#else
+    #define SUPERINSTRUCTION_ENTRIES 64
+#endif
+
+/* Instructions fused into a single superinstruction */
+#define SUPERINSTRUCTION_LENGTH 2
+
+typedef struct {
+    uint16_t tag;     /* Mapped start address, 0 if empty */
+    uint8_t  length;  /* Instructions fused, 0 if the address starts no idiom */
+    uint8_t  cycles;  /* Clock cycles taken if every branch and page crossing is taken */
+    decoded_instruction_t instructions[SUPERINSTRUCTION_LENGTH];
+} superinstruction_t;
+
+const superinstruction_t * superinstruction_lookup(uint16_t address);
+void superinstruction_invalidate(void);
+
+#endif /* _MOS6507_SUPERINSTRUCTIONS_H */
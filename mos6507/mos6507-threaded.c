@@ -0,0 +1,124 @@
+/*
+ * File: mos6507-threaded.c
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Translates basic blocks of cartridge code into threaded code.
+ *
+ * A block is a run of instructions which can't disturb the TIA or RIOT:
+ * those without a memory operand and those whose operand is known ahead
+ * of time to be RAM or ROM. It ends at the first instruction which may
+ * access a device or change the flow of control, with a trailing
+ * conditional branch included. As nothing else in the system needs to see
+ * the CPU part way through such a run, it can be executed straight
+ * through from pre-decoded instructions and accounted for by its cycle
+ * total alone. Everything else falls back to the cycle stepper.
+ */
+
+#ifdef THREADED_CODE
+#ifndef ATOMIC_INSTRUCTIONS
+    #error "THREADED_CODE requires ATOMIC_INSTRUCTIONS"
+#endif
+
+#include "atari/Atari-memmap.h"
+#include "mos6507-threaded.h"
+
+static threaded_block_t blocks[THREADED_BLOCKS] = {0};
+
+/* Returns 1 if an instruction may be included within a block */
+static int threaded_is_pure(const decoded_instruction_t *decoded)
+{
+    switch (decoded->instruction->mode) {
+        case ADDRESSING_IMPLIED:
+        case ADDRESSING_IMMEDIATE:
+        case ADDRESSING_RELATIVE:
+            return 1;
+        case ADDRESSING_ZERO_PAGE:
+            return !memmap_is_device(decoded->operand[0]);
+        case ADDRESSING_ABSOLUTE:
+            return !memmap_is_device((decoded->operand[1] << 8) | decoded->operand[0]);
+        default:
+            return 0;
+    }
+}
+
+/* Decodes instructions from the start of a block until one which can't
+ * be included is reached. Blocks of a single instruction are left
+ * untranslated as they would gain nothing over the cycle stepper.
+ */
+static void threaded_translate(threaded_block_t *block)
+{
+    const decoded_instruction_t *decoded;
+    uint16_t address = block->tag;
+    uint8_t length = 0;
+    uint8_t cycles = 0;
+    int i;
+
+    while (length < THREADED_BLOCK_LENGTH) {
+        decoded = decode_cache_lookup(address);
+        if (!decoded || !threaded_is_pure(decoded)) {
+            break;
+        }
+        block->instructions[length++] = *decoded;
+        /* Count every step, including those for a branch being taken
+         * and crossing a page, for the worst case
+         */
+        for (i=0; i<OPCODE_MAX_CYCLES && decoded->instruction->steps[i]; i++) {
+            cycles++;
+        }
+        if (ADDRESSING_RELATIVE == decoded->instruction->mode) {
+            break;
+        }
+        address += decoded->instruction->length;
+    }
+
+    if (length > 1) {
+        block->length = length;
+        block->cycles = cycles;
+    }
+}
+
+/* Finds the translated block starting at an address, translating it once
+ * it has been entered often enough to be worthwhile.
+ *
+ * address: location of the first op-code, as held in the program counter
+ *
+ * Returns NULL if no block has been translated at the address.
+ */
+const threaded_block_t * threaded_lookup(uint16_t address)
+{
+    threaded_block_t *block;
+
+    /* Match the mirroring applied by the memory map */
+    address &= 0x1FFF;
+    if (address < MEMMAP_CART_START) {
+        return 0;
+    }
+
+    block = &blocks[address % THREADED_BLOCKS];
+    if (block->tag != address) {
+        block->tag = address;
+        block->heat = 0;
+        block->length = 0;
+    }
+    if (block->length) {
+        return block;
+    }
+    if (block->heat < THREADED_HOT_THRESHOLD) {
+        if (++block->heat == THREADED_HOT_THRESHOLD) {
+            threaded_translate(block);
+        }
+    }
+    return block->length ? block : 0;
+}
+
+void threaded_invalidate(void)
+{
+    int i;
+    for (i=0; i<THREADED_BLOCKS; i++) {
+        blocks[i].tag = 0;
+        blocks[i].length = 0;
+    }
+}
+
+#endif /* THREADED_CODE */
@@ -0,0 +1,40 @@
+/*
+ * File: mos6507-threaded.h
+ * Author: dgrubb
+ * Date: 10/17/2026
+ *
+ * Translates basic blocks of cartridge code into threaded code.
+ */
+
+#ifndef _MOS6507_THREADED_H
+#define _MOS6507_THREADED_H
+
+#include <stdint.h>
+#include "mos6507-decode-cache.h"
+
+/* Blocks are direct mapped by their start address. As with the decode
+ * cache the FE310 only has room for a handful of the hottest loops.
+ */
+#ifdef HOST_BUILD
+    #define THREADED_BLOCKS       256
+    #define THREADED_BLOCK_LENGTH 16
+#else
+    #define THREADED_BLOCKS       16
+    #define THREADED_BLOCK_LENGTH 8
+#endif
+
+/* Number of times a block must be entered before it is translated */
+#define THREADED_HOT_THRESHOLD 2
+
+typedef struct {
+    uint16_t tag;     /* Mapped start address, 0 if empty */
+    uint8_t  heat;    /* Times entered, up to THREADED_HOT_THRESHOLD */
+    uint8_t  length;  /* Instructions in the block, 0 if not translated */
+    uint8_t  cycles;  /* Clock cycles taken if every branch and page crossing is taken */
+    decoded_instruction_t instructions[THREADED_BLOCK_LENGTH];
+} threaded_block_t;
+
+const threaded_block_t * threaded_lookup(uint16_t address);
+void threaded_invalidate(void);
+
+#endif /* _MOS6507_THREADED_H */
@@ -10,11 +10,51 @@
 #ifdef PRINT_STATE
     #include "test/debug.h"
 #endif
+#ifdef THREADED_CODE
+    #include "mos6507-threaded.h"
+#endif
+#ifdef AOT_CODE
+    #include "mos6507-aot.h"
+#endif
+#ifdef DYNAREC
+    #include "mos6507-dynarec.h"
+#endif
+#ifdef SUPERINSTRUCTIONS
+    #include "mos6507-superinstructions.h"
+#endif
 #include "mos6507.h"
 
 /* Representation of our CPU */
 static mos6507 cpu = {0};
 
+#ifdef SUPERINSTRUCTIONS
+/* Runs the instructions of a superinstruction back to back. The cycle in
+ * progress is published before each step, as in mos6507_run(), as the
+ * instructions may access the TIA or RIOT.
+ *
+ * fused: superinstruction located at the program counter
+ * cycles: clock cycles consumed so far within mos6507_run()
+ *
+ * Returns the clock cycles consumed including the superinstruction.
+ */
+static int mos6507_run_superinstruction(const superinstruction_t *fused, int cycles)
+{
+    const step_t *step;
+    int i;
+
+    for (i=0; i<fused->length; i++) {
+        cycles += cpu.stall;
+        cpu.stall = 0;
+        opcode_bind(&fused->instructions[i]);
+        step = fused->instructions[i].instruction->steps;
+        do {
+            cpu.run_cycle = cycles++;
+        } while (-1 == (*step++)());
+    }
+    return cycles;
+}
+#endif
+
 /* Invoking this function causes the state of the CPU to update
  * as if receiving an external clock tick. Note that the 6507
  * required at least two clock cycles to execute an opcode, usually
@@ -22,31 +62,148 @@ static mos6507 cpu = {0};
  */
 int mos6507_clock_tick(void)
 {
+    /* Cycles already accounted for by skipping ahead pass with no work */
+    if (cpu.stall) {
+        cpu.stall--;
+        return 0;
+    }
     /* If the CPU is still in the middle of decoding/executing an
      * operation then continue execution. Otherwise, read the next 
      * opcode out of memory and begin decode.
      */
-    if (!cpu.current_instruction) {
-        memmap_read(&cpu.current_instruction);
-    }
-    if (opcode_validate(cpu.current_instruction)) {
+    if (!cpu.current_clock) {
+        opcode_fetch(&cpu.current_instruction);
+        if (opcode_validate(cpu.current_instruction)) {
 #ifdef PRINT_STATE
-        debug_print_illegal_opcode(cpu.current_instruction);
+            debug_print_illegal_opcode(cpu.current_instruction);
 #endif
-        return -1;
+            return -1;
+        }
     }
 #ifdef PRINT_STATE
     debug_print_execution_step();
 #endif
 
-    cpu.current_clock = opcode_execute(cpu.current_instruction);
+    cpu.current_clock = opcode_execute(cpu.current_instruction, cpu.current_clock);
+    return 0;
+}
 
-    if(!cpu.current_clock) {
-        cpu.current_instruction = 0;
+/* Runs the CPU for a batch of clock cycles in a single call rather than a
+ * clock tick at a time. Instructions are started until the cycle budget is
+ * used up or the TIA halts the CPU through RDY (i.e., WSYNC), and the
+ * instruction in flight is always completed, so the budget may be overrun
+ * by up to OPCODE_MAX_CYCLES-1 cycles, or further if an idle loop is
+ * skipped (see mos6507_stall()). Memory is accessed in the same order
+ * as when clocked, and mos6507_get_run_cycle() reports the cycle in
+ * progress so other devices can be brought up to date before being
+ * accessed.
+ *
+ * cycle_budget: number of clock cycles to run for
+ *
+ * Returns the number of clock cycles consumed, or -1 on an illegal op-code.
+ */
+int mos6507_run(int cycle_budget)
+{
+    /* Decode state is held locally for the duration of the batch */
+    uint8_t instruction = cpu.current_instruction;
+    uint8_t clock = cpu.current_clock;
+    int cycles = 0;
+#ifdef AOT_CODE
+    const aot_block_t *translated;
+#endif
+#ifdef DYNAREC
+    const dynarec_block_t *compiled;
+#endif
+#ifdef THREADED_CODE
+    const threaded_block_t *block;
+#endif
+#ifdef SUPERINSTRUCTIONS
+    const superinstruction_t *fused;
+#endif
+
+    while (clock || (cpu.RDY && cycles < cycle_budget)) {
+        /* Cycles skipped by the last instruction (see mos6507_stall()) */
+        cycles += cpu.stall;
+        cpu.stall = 0;
+#ifdef AOT_CODE
+        /* Blocks translated ahead of time, as for threaded code below */
+        if (!clock) {
+            translated = aot_lookup(cpu.PC);
+            if (translated && (cycles + translated->cycles <= cycle_budget)) {
+                cycles += translated->code();
+                continue;
+            }
+        }
+#endif
+#ifdef DYNAREC
+        /* Blocks compiled to native code, as for threaded code below */
+        if (!clock) {
+            compiled = dynarec_lookup(cpu.PC);
+            if (compiled && (cycles + compiled->cycles <= cycle_budget)) {
+                cycles += compiled->code();
+                continue;
+            }
+        }
+#endif
+#ifdef THREADED_CODE
+        /* Translated blocks can't touch the TIA or RIOT, so are run whole
+         * provided they are certain to fit within the budget.
+         */
+        if (!clock) {
+            block = threaded_lookup(cpu.PC);
+            if (block && (cycles + block->cycles <= cycle_budget)) {
+                cycles += opcode_execute_block(block->instructions, block->length);
+                continue;
+            }
+        }
+#endif
+#ifdef SUPERINSTRUCTIONS
+        /* Common pairs of instructions are dispatched once between them,
+         * provided they are certain to fit within the budget.
+         */
+        if (!clock) {
+            fused = superinstruction_lookup(cpu.PC);
+            if (fused && (cycles + fused->cycles <= cycle_budget)) {
+                cycles = mos6507_run_superinstruction(fused, cycles);
+                continue;
+            }
+        }
+#endif
+        if (!clock) {
+            opcode_fetch(&instruction);
+            if (opcode_validate(instruction)) {
+#ifdef PRINT_STATE
+                debug_print_illegal_opcode(instruction);
+#endif
+                cpu.current_instruction = instruction;
+                return -1;
+            }
+        }
+#ifdef PRINT_STATE
+        cpu.current_instruction = instruction;
+        cpu.current_clock = clock;
+        debug_print_execution_step();
+#endif
+        cpu.run_cycle = cycles;
+        clock = opcode_execute(instruction, clock);
+        cycles++;
     }
-    return 0;
+
+    cpu.current_instruction = instruction;
+    cpu.current_clock = clock;
+    return cycles;
 }
 
+#ifdef DYNAREC
+/* Exposes the CPU's registers to code generated at run time, which reads
+ * and writes them directly.
+ */
+mos6507 * mos6507_get_state(void)
+{
+    return &cpu;
+}
+#endif
+
 void mos6507_reset(void)
 {
     uint8_t pch, pcl = 0;
@@ -70,10 +227,8 @@ void mos6507_reset(void)
      * just a few bytes in length.
      */
 
-    mos6507_set_address_bus(0xFFFC);
-    memmap_read(&pcl);
-    mos6507_set_address_bus(0xFFFD);
-    memmap_read(&pch);
+    pcl = memmap_bus_read(0xFFFC);
+    pch = memmap_bus_read(0xFFFD);
 
     /* Pack the two bytes found at the reset vector into 
      * the program counter and initialise it as the true
@@ -95,10 +250,17 @@ void mos6507_init(void)
     cpu.PC = 0;
     cpu.S =  0xFF;
     cpu.P =  0;
+    cpu.N_result = 0;
+    cpu.Z_result = 1;
+    cpu.C = 0;
+    cpu.V = 0;
     cpu.data_bus = 0;
     cpu.address_bus = 0;
     cpu.current_instruction = 0;
     cpu.current_clock = 0;
+    cpu.run_cycle = 0;
+    cpu.RDY = 1;
+    cpu.stall = 0;
 }
 
 void mos6507_set_register(mos6507_register_t reg, uint8_t value)
@@ -109,7 +271,14 @@ void mos6507_set_register(mos6507_register_t reg, uint8_t value)
         case MOS6507_REG_X:  cpu.X  = value; break;
         case MOS6507_REG_PC: cpu.PC = value; break;
         case MOS6507_REG_S:  cpu.S  = value; break;
-        case MOS6507_REG_P:  cpu.P  = value; break;
+        case MOS6507_REG_P:
+            cpu.P = value & ~(MOS6507_STATUS_FLAG_NEGATIVE | MOS6507_STATUS_FLAG_ZERO |
+                              MOS6507_STATUS_FLAG_CARRY | MOS6507_STATUS_FLAG_OVERFLOW);
+            cpu.N_result = value & MOS6507_STATUS_FLAG_NEGATIVE;
+            cpu.Z_result = !(value & MOS6507_STATUS_FLAG_ZERO);
+            cpu.C = (value & MOS6507_STATUS_FLAG_CARRY) ? 1 : 0;
+            cpu.V = (value & MOS6507_STATUS_FLAG_OVERFLOW) ? 1 : 0;
+            break;
         default: /* Handle error */ break;
     }
 }
@@ -122,7 +291,13 @@ void mos6507_get_register(mos6507_register_t reg, uint8_t *value)
         case MOS6507_REG_X:  *value = cpu.X;  break;
         case MOS6507_REG_PC: *value = cpu.PC; break;
         case MOS6507_REG_S:  *value = cpu.S;  break;
-        case MOS6507_REG_P:  *value = cpu.P;  break;
+        case MOS6507_REG_P:
+            /* Materialise the lazily evaluated flags */
+            *value = cpu.P | (cpu.N_result & MOS6507_STATUS_FLAG_NEGATIVE);
+            if (!cpu.Z_result) *value |= MOS6507_STATUS_FLAG_ZERO;
+            if (cpu.C) *value |= MOS6507_STATUS_FLAG_CARRY;
+            if (cpu.V) *value |= MOS6507_STATUS_FLAG_OVERFLOW;
+            break;
         default: /* Handle error */ break;
     }
 }
@@ -190,20 +365,46 @@ char * mos6507_get_register_str(mos6507_register_t reg)
 }
 
 void mos6507_set_status_flag(mos6507_status_flag_t flag, int value) {
-    uint8_t status;
-    mos6507_get_register(MOS6507_REG_P, &status);
-    if (value) {
-        status |= flag;
-    } else {
-        status &= ~flag;
+    switch(flag) {
+        case MOS6507_STATUS_FLAG_NEGATIVE: cpu.N_result = value ? 0x80 : 0; break;
+        case MOS6507_STATUS_FLAG_ZERO:     cpu.Z_result = value ? 0 : 1; break;
+        case MOS6507_STATUS_FLAG_CARRY:    cpu.C = value ? 1 : 0; break;
+        case MOS6507_STATUS_FLAG_OVERFLOW: cpu.V = value ? 1 : 0; break;
+        default:
+            if (value) {
+                cpu.P |= flag;
+            } else {
+                cpu.P &= ~flag;
+            }
+            break;
     }
-    mos6507_set_register(MOS6507_REG_P, status);
 }
 
 int mos6507_get_status_flag(mos6507_status_flag_t flag) {
-    uint8_t status;
-    mos6507_get_register(MOS6507_REG_P, &status);
-    return (status & flag) ? 1 : 0;
+    switch(flag) {
+        case MOS6507_STATUS_FLAG_NEGATIVE: return (cpu.N_result & 0x80) ? 1 : 0;
+        case MOS6507_STATUS_FLAG_ZERO:     return cpu.Z_result ? 0 : 1;
+        case MOS6507_STATUS_FLAG_CARRY:    return cpu.C;
+        case MOS6507_STATUS_FLAG_OVERFLOW: return cpu.V;
+        default:                           return (cpu.P & flag) ? 1 : 0;
+    }
+}
+
+/* Records the result of an operation from which the negative and zero
+ * flags are derived, without evaluating them.
+ */
+void mos6507_set_NZ(uint8_t result)
+{
+    cpu.N_result = result;
+    cpu.Z_result = result;
+}
+
+/* As mos6507_set_NZ(), also setting carry */
+void mos6507_set_NZC(uint8_t result, int carry)
+{
+    cpu.N_result = result;
+    cpu.Z_result = result;
+    cpu.C = carry ? 1 : 0;
 }
 
 void mos6507_get_current_instruction(uint8_t *instruction)
@@ -216,13 +417,32 @@ void mos6507_get_current_instruction_cycle(uint8_t *instruction_cycle)
     *instruction_cycle = cpu.current_clock;
 }
 
+void mos6507_get_run_cycle(uint16_t *run_cycle)
+{
+    *run_cycle = cpu.run_cycle;
+}
+
+void mos6507_set_RDY(int ready)
+{
+    cpu.RDY = ready ? 1 : 0;
+}
+
+/* Skips the CPU ahead by a number of clock cycles, during which it does no
+ * work. The caller is responsible for leaving the emulated state as it
+ * would have been after running those cycles.
+ *
+ * cycles: number of clock cycles to skip
+ */
+void mos6507_stall(uint32_t cycles)
+{
+    cpu.stall += cycles;
+}
+
 void mos6507_push_stack(uint8_t byte)
 {
     uint8_t S;
     mos6507_get_register(MOS6507_REG_S, &S);
-    mos6507_set_address_bus_hl(STACK_PAGE, S);
-    mos6507_set_data_bus(byte);
-    memmap_write();
+    memmap_bus_write((STACK_PAGE << 8) | S, byte);
     mos6507_set_register(MOS6507_REG_S, S-1);
 #ifdef PRINT_STATE
     debug_print_stack_action(DEBUG_STACK_ACTION_PUSH);
@@ -233,8 +453,7 @@ void mos6507_pull_stack(uint8_t *byte)
 {
     uint8_t S;
     mos6507_get_register(MOS6507_REG_S, &S);
-    mos6507_set_address_bus_hl(STACK_PAGE, S+1);
-    memmap_read(byte);
+    *byte = memmap_bus_read((STACK_PAGE << 8) | (uint8_t)(S+1));
     mos6507_set_register(MOS6507_REG_S, S+1);
 #ifdef PRINT_STATE
     debug_print_stack_action(DEBUG_STACK_ACTION_PULL);
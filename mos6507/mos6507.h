@@ -40,17 +40,29 @@ typedef struct {
     uint8_t  X;   /* X register */
     uint16_t PC;  /* Program counter */
     uint8_t  S;   /* Stack pointer */
-    uint8_t  P;   /* Status register */
+    uint8_t  P;   /* Status register, excluding the lazily evaluated flags below */
+    /* N, Z, C and V are written by almost every instruction but only read
+     * by branches, PHP and BRK, so the inputs are stored and the flags
+     * evaluated on demand.
+     */
+    uint8_t  N_result; /* Negative flag is bit 7 of this value */
+    uint8_t  Z_result; /* Zero flag is set when this value is 0 */
+    uint8_t  C;        /* Carry flag, 0 or 1 */
+    uint8_t  V;        /* Overflow flag, 0 or 1 */
     /* State description */
     uint8_t       current_instruction; /* Current op-code and addressing mode */
     uint8_t       current_clock;       /* Current clock tick of the current instruction */
-    uint16_t      address_bus;         /* Address bus */
-    uint8_t       data_bus;            /* Data bus */
+    uint16_t      address_bus;         /* Address bus, only latched when tracing (PRINT_STATE) */
+    uint8_t       data_bus;            /* Data bus, only latched when tracing (PRINT_STATE) */
+    uint16_t      run_cycle;           /* Clock cycle in progress within mos6507_run() */
+    uint8_t       RDY;                 /* Ready input, pulled low to halt the CPU */
+    uint32_t      stall;               /* Clock cycles skipped, e.g., an idle loop, still to pass */
 } mos6507;
 
 void mos6507_init(void);
 void mos6507_reset(void);
 int mos6507_clock_tick(void);
+int mos6507_run(int cycle_budget);
 void mos6507_set_register(mos6507_register_t reg, uint8_t value);
 void mos6507_get_register(mos6507_register_t reg, uint8_t *value);
 void mos6507_set_address_bus_hl(uint8_t adh, uint8_t adl);
@@ -64,10 +76,18 @@ void mos6507_set_PC(uint16_t pc);
 void mos6507_set_PC_hl(uint8_t pch, uint8_t pcl);
 void mos6507_set_status_flag(mos6507_status_flag_t flag, int value);
 int mos6507_get_status_flag(mos6507_status_flag_t flag);
+void mos6507_set_NZ(uint8_t result);
+void mos6507_set_NZC(uint8_t result, int carry);
 char * mos6507_get_register_str(mos6507_register_t reg);
 void mos6507_get_current_instruction(uint8_t *instruction);
 void mos6507_get_current_instruction_cycle(uint8_t *instruction_cycle);
+void mos6507_get_run_cycle(uint16_t *run_cycle);
+void mos6507_set_RDY(int ready);
+void mos6507_stall(uint32_t cycles);
 void mos6507_push_stack(uint8_t byte);
 void mos6507_pull_stack(uint8_t *byte);
+#ifdef DYNAREC
+mos6507 * mos6507_get_state(void);
+#endif
 
 #endif /* _MOS6507_H */
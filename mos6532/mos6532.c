@@ -12,7 +12,21 @@
 #include "mos6532.h"
 
 static uint8_t memory[MEM_SIZE];
-mos6532_timer_t timer;
+
+/* The interval timer is only brought up to date when it's observed, from
+ * the clock ticks which have passed since it last was, rather than being
+ * stepped on every tick.
+ */
+static mos6532_timer_t timer;
+static uint32_t clock_ticks = 0;    /* Clock ticks received since initialisation */
+static uint32_t timer_updated = 0;  /* Clock tick the timer was last brought up to date at */
+
+/* Brings the interval timer up to date with the ticks received */
+static void mos6532_update_timer(void)
+{
+    mos6532_timer_advance(&timer, clock_ticks - timer_updated);
+    timer_updated = clock_ticks;
+}
 
 void mos6532_init(void)
 {
@@ -20,6 +34,8 @@ void mos6532_init(void)
     timer.timer_set = MOS6532_TIMER_DIVISOR_NONE;
     timer.interval_timer = 0;
     timer.counter = 0;
+    clock_ticks = 0;
+    timer_updated = 0;
     mos6532_clear_memory();
 }
 
@@ -39,6 +55,13 @@ int mos6532_bounds_check(uint16_t address)
     return 0;
 }
 
+/* Gives direct access to RAM for the memory map
+ */
+uint8_t * mos6532_get_memory(void)
+{
+    return memory;
+}
+
 /* Resets all RAM to zero
  */
 void mos6532_clear_memory(void)
@@ -59,8 +82,14 @@ int mos6532_read(uint16_t address, uint8_t *data)
      */
     switch (address) {
         case MOS6532_MEMMAP_INTIM:
+            mos6532_update_timer();
             *data = timer.counter;
             return 0;
+        case MOS6532_MEMMAP_TIMINT:
+            /* The timer's interrupt flag is presented on D7 */
+            mos6532_update_timer();
+            *data = timer.fired ? 0x80 : 0x00;
+            return 0;
     }
     if (-1 == mos6532_bounds_check(address)) {
         /* Error, attempting to read outside memory */
@@ -81,6 +110,7 @@ int mos6532_set_timer(mos6532_timer_divisor_t divisor, uint8_t data)
     timer.interval_timer = divisor;
     timer.counter = data;
     timer.fired = 0;
+    timer_updated = clock_ticks;
 }
 
 /* Writes to a RAM address.
@@ -115,53 +145,92 @@ int mos6532_write(uint16_t address, uint8_t data)
     return 0;
 }
 
-void mos6532_timer_interval(mos6532_timer_divisor_t divisor)
+void mos6532_clock_tick(void)
 {
-    timer.interval_timer--;
-    if (timer.interval_timer == 0) {
-        timer.interval_timer = timer.timer_set;
-        timer.counter--;
-        if (timer.fired == 1) {
-            timer.timer_set = MOS6532_TIMER_DIVISOR_NONE;
-        }
-    }
-    if (timer.counter == 0) {
-        timer.fired = 1;
-    }
+    clock_ticks++;
 }
 
-void mos6532_clock_tick(void)
+/* Equivalent to calling mos6532_clock_tick() a number of times.
+ *
+ * ticks: number of clock ticks
+ */
+void mos6532_clock_ticks(uint32_t ticks)
 {
-    switch (timer.timer_set) {
-        case MOS6532_TIMER_DIVISOR_T1:
-            mos6532_timer_interval(MOS6532_TIMER_DIVISOR_T1);
-            break;
-        case MOS6532_TIMER_DIVISOR_T8:
-            mos6532_timer_interval(MOS6532_TIMER_DIVISOR_T8);
-            break;
-        case MOS6532_TIMER_DIVISOR_T64:
-            mos6532_timer_interval(MOS6532_TIMER_DIVISOR_T64);
-            break;
-        case MOS6532_TIMER_DIVISOR_T1024:
-            mos6532_timer_interval(MOS6532_TIMER_DIVISOR_T1024);
-            break;
-        case MOS6532_TIMER_DIVISOR_NONE:
-            timer.counter--;
-            break;
-        default:
-            /* No timer set */
-            break;
+    clock_ticks += ticks;
+}
+
+/* Applies a number of clock ticks to a timer in one go. Each tick
+ * decrements the interval, and the counter as the interval elapses. Once
+ * the counter has reached 0 it then decrements on every tick, as the 6532
+ * does after an underflow. Whole intervals are skipped at once rather than
+ * ticking through them.
+ *
+ * state: timer to advance, e.g., a copy of the RIOT's own for prediction
+ * ticks: number of clock ticks to apply
+ */
+void mos6532_timer_advance(mos6532_timer_t *state, uint32_t ticks)
+{
+    uint32_t step;
+
+    while (ticks) {
+        switch (state->timer_set) {
+            case MOS6532_TIMER_DIVISOR_T1:
+            case MOS6532_TIMER_DIVISOR_T8:
+            case MOS6532_TIMER_DIVISOR_T64:
+            case MOS6532_TIMER_DIVISOR_T1024:
+                /* Ticks until the interval elapses, the 8-bit interval
+                 * wrapping around from 0
+                 */
+                step = state->interval_timer ? state->interval_timer : 256;
+                if (ticks < step) {
+                    state->interval_timer -= ticks;
+                    if (state->counter == 0) {
+                        state->fired = 1;
+                    }
+                    return;
+                }
+                ticks -= step;
+                if (step > 1 && state->counter == 0) {
+                    state->fired = 1;
+                }
+                /* The final tick of the interval */
+                state->interval_timer = state->timer_set;
+                state->counter--;
+                if (state->fired == 1) {
+                    state->timer_set = MOS6532_TIMER_DIVISOR_NONE;
+                }
+                if (state->counter == 0) {
+                    state->fired = 1;
+                }
+                break;
+            case MOS6532_TIMER_DIVISOR_NONE:
+                state->counter -= ticks;
+                return;
+            default:
+                /* No timer set */
+                return;
+        }
     }
 }
 
+/* Gives an up to date copy of the interval timer, e.g., to predict its
+ * future values with mos6532_timer_advance().
+ */
+void mos6532_get_timer(mos6532_timer_t *state)
+{
+    mos6532_update_timer();
+    *state = timer;
+}
 
 void mos6532_get_interval(mos6532_timer_divisor_t *divisor)
 {
+    mos6532_update_timer();
     *divisor = timer.timer_set;
 }
 
 void mos6532_get_counter(uint8_t *counter)
 {
+    mos6532_update_timer();
     *counter = timer.counter;
 }
 
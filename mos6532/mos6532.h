@@ -15,6 +15,7 @@
 #define MEM_SIZE 128
 
 #define MOS6532_MEMMAP_INTIM    0x284
+#define MOS6532_MEMMAP_TIMINT   0x285
 #define MOS6532_MEMMAP_TIM1T    0x294
 #define MOS6532_MEMMAP_TIM8T    0x295
 #define MOS6532_MEMMAP_TIM64T   0x296
@@ -35,18 +36,19 @@ typedef struct {
     mos6532_timer_divisor_t timer_set;
 } mos6532_timer_t;
 
-mos6532_timer_t timer;
-
 /* Utility functions */
 int mos6532_bounds_check(uint16_t address);
 void mos6532_clear_memory(void);
+uint8_t * mos6532_get_memory(void);
 void mos6532_init(void);
 int mos6532_set_timer(mos6532_timer_divisor_t divisor, uint8_t data);
-void mos6532_timer_interval(mos6532_timer_divisor_t divisor);
 /* External memory access */
 int mos6532_read(uint16_t address, uint8_t *data);
 int mos6532_write(uint16_t address, uint8_t data);
 void mos6532_clock_tick(void);
+void mos6532_clock_ticks(uint32_t ticks);
+void mos6532_timer_advance(mos6532_timer_t *state, uint32_t ticks);
+void mos6532_get_timer(mos6532_timer_t *state);
 void mos6532_get_interval(mos6532_timer_divisor_t *divisor);
 void mos6532_get_counter(uint8_t *counter);
 char * mos6532_get_divisor_str(mos6532_timer_divisor_t divisor);
@@ -67,8 +67,8 @@ debug_opcode_t debug_opcodes[] = {
     {0x8E, "STX - Absolute"},
     /* STY */
     {0x84, "STY - Zero page"},
-    {0x94, "STY - Zero page Y indexed"},
-    {0x8E, "STY - Absolute"},
+    {0x94, "STY - Zero page X indexed"},
+    {0x8C, "STY - Absolute"},
     /* ADC */
     {0x69, "ADC - Immediate"},
     {0x65, "ADC - Zero page"},
@@ -95,7 +95,7 @@ debug_opcode_t debug_opcodes[] = {
     /* INX */
     {0xE8, "INX - Implied"},
     /* INY */
-    {0xFE, "INY - Implied"},
+    {0xC8, "INY - Implied"},
     /* DEC */
     {0xC6, "DEC - Zero page"},
     {0xD6, "DEC - Zero page X indexed"},
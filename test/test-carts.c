@@ -31,15 +31,15 @@ const uint8_t test_cart_LDA_Zero_Page_X_Indexed[2] = {
 };
 
 const uint8_t test_cart_LDA_Absolute[3] = {
-    0xB5, /* LDA, Load accumulator with ... */
-    0x01, /* ... the contents of this low address byte ... */
-    0x20  /* ... and this high address byte ... */
+    0xAD, /* LDA, Load accumulator with ... */
+    0x81, /* ... the contents of this low address byte ... */
+    0x01  /* ... and this high address byte ... */
 };
 
 const uint8_t test_cart_LDA_Absolute_X_Indexed[3] = {
     0xBD, /* LDA, Load accumulator with ... */
-    0x00, /* ... the contents of this low address byte ... */
-    0x20  /* ... and this high address byte ... */
+    0x80, /* ... the contents of this low address byte ... */
+    0x01  /* ... and this high address byte ... */
 };
 
 const uint8_t test_cart_LDA_Absolute_X_Indexed_Boundary_Cross[3] = {
@@ -50,8 +50,8 @@ const uint8_t test_cart_LDA_Absolute_X_Indexed_Boundary_Cross[3] = {
 
 const uint8_t test_cart_LDA_Absolute_Y_Indexed[3] = {
     0xB9, /* LDA, Load accumulator with ... */
-    0x00, /* ... the contents of this low address byte ... */
-    0x20  /* ... and this high address byte ... */
+    0x80, /* ... the contents of this low address byte ... */
+    0x01  /* ... and this high address byte ... */
 };
 
 const uint8_t test_cart_LDA_Absolute_Y_Indexed_Boundary_Cross[3] = {
@@ -67,8 +67,8 @@ const uint8_t test_cart_LDA_Indirect_X_Indexed[3] = {
 };
 
 const uint8_t test_cart_LDA_Indirect_Y_Indexed[3] = {
-    0xA1, /* LDA, Load accumulator with ... */
-    0x90, /* ... an address in zero-page which ... */
+    0xB1, /* LDA, Load accumulator with ... */
+    0x91, /* ... an address in zero-page which ... */
     0x00  /* ... combined with the Y index register yeilds the actual data */
 };
 
@@ -93,14 +93,14 @@ const uint8_t test_cart_LDX_Zero_Page_Y_Indexed[2] = {
 
 const uint8_t test_cart_LDX_Absolute[3] = {
     0xAE, /* LDX, Load X index with ... */
-    0x01, /* ... the contents of this low address byte ... */
-    0x20  /* ... and this high address byte ... */
+    0x81, /* ... the contents of this low address byte ... */
+    0x01  /* ... and this high address byte ... */
 };
 
 const uint8_t test_cart_LDX_Absolute_Y_Indexed[3] = {
-    0xAE, /* LDX, Load X index with ... */
-    0x00, /* ... the contents of this low address byte ... */
-    0x20  /* ... and this high address byte ... */
+    0xBE, /* LDX, Load X index with ... */
+    0x80, /* ... the contents of this low address byte ... */
+    0x01  /* ... and this high address byte ... */
 };
 
 const uint8_t test_cart_LDX_Absolute_Y_Indexed_Boundary_Cross[3] = {
@@ -131,14 +131,14 @@ const uint8_t test_cart_LDY_Zero_Page_X_Indexed[2] = {
 
 const uint8_t test_cart_LDY_Absolute[3] = {
     0xAC, /* LDY, Load Y index with ... */
-    0x01, /* ... the contents of this low address byte ... */
-    0x20  /* ... and this high address byte ... */
+    0x81, /* ... the contents of this low address byte ... */
+    0x01  /* ... and this high address byte ... */
 };
 
 const uint8_t test_cart_LDY_Absolute_X_Indexed[3] = {
     0xBC, /* LDY, Load Y index with ... */
-    0x00, /* ... the contents of this low address byte ... */
-    0x20  /* ... and this high address byte ... */
+    0x80, /* ... the contents of this low address byte ... */
+    0x01  /* ... and this high address byte ... */
 };
 
 const uint8_t test_cart_LDY_Absolute_X_Indexed_Boundary_Cross[3] = {
@@ -182,25 +182,25 @@ const uint8_t test_cart_STA_Absolute_X_Indexed[5] = {
 };
 
 const uint8_t test_cart_STA_Absolute_Y_Indexed[5] = {
-    0x99, /* LDA, load accumulator with ... */
+    0xA9, /* LDA, load accumulator with ... */
     0xBB, /* ... this value */
-    0x9D, /* The move the accumulator contents ... */
+    0x99, /* The move the accumulator contents ... */
     0xF0, /* ... low byte ... */
     0x01 /* ... high byte ... */
 };
 
 const uint8_t test_cart_STA_Indirect_X_Indexed[4] = {
-    0x99, /* LDA, load accumulator with ... */
+    0xA9, /* LDA, load accumulator with ... */
     0xBB, /* ... this value */
     0x81, /* Then move accumulator contents ... */
     0x90  /* ... to this address + index offset*/
 };
 
 const uint8_t test_cart_STA_Indirect_Y_Indexed[4] = {
-    0x99, /* LDA, load accumulator with ... */
+    0xA9, /* LDA, load accumulator with ... */
     0xBB, /* ... this value */
     0x91, /* Then move accumulator contents ... */
-    0x90  /* ... to this address + index offset*/
+    0x95  /* ... to the address held here + index offset*/
 };
 
 /******************************************************************************
@@ -255,5 +255,86 @@ const uint8_t test_cart_STY_Absolute[5] = {
     0x01  /* ... and this high byte */
 };
 
+/******************************************************************************
+ * ADC
+ *****************************************************************************/
+
+const uint8_t test_cart_ADC_Immediate[4] = {
+    0xA9, /* LDA, load accumulator with ... */
+    0xFB, /* ... this value */
+    0x69, /* ADC, add to the accumulator ... */
+    0x0F  /* ... this value, overflowing into the carry */
+};
+
+const uint8_t test_cart_ADC_Decimal[7] = {
+    0xF8, /* SED, switch to decimal mode */
+    0x18, /* CLC, clear the carry */
+    0xA9, /* LDA, load accumulator with ... */
+    0x99, /* ... 99 in BCD */
+    0x69, /* ADC, add to the accumulator ... */
+    0x01, /* ... 1 in BCD, carrying out of 99 */
+    0xEA  /* NOP */
+};
+
+/******************************************************************************
+ * SBC
+ *****************************************************************************/
+
+const uint8_t test_cart_SBC_Decimal[7] = {
+    0xF8, /* SED, switch to decimal mode */
+    0x38, /* SEC, set the carry (no borrow) */
+    0xA9, /* LDA, load accumulator with ... */
+    0x00, /* ... 0 in BCD */
+    0xE9, /* SBC, subtract from the accumulator ... */
+    0x01, /* ... 1 in BCD, borrowing below 0 */
+    0xEA  /* NOP */
+};
+
+/******************************************************************************
+ * Shifts and rotates
+ *****************************************************************************/
+
+const uint8_t test_cart_ASL_Zero_Page[2] = {
+    0x06, /* ASL, shift left the contents of ... */
+    0x81  /* ... this zero page location */
+};
+
+const uint8_t test_cart_LSR_Zero_Page[2] = {
+    0x46, /* LSR, shift right the contents of ... */
+    0x81  /* ... this zero page location */
+};
+
+const uint8_t test_cart_ROL_Zero_Page[2] = {
+    0x26, /* ROL, rotate left the contents of ... */
+    0x81  /* ... this zero page location */
+};
+
+const uint8_t test_cart_ROR_Zero_Page[2] = {
+    0x66, /* ROR, rotate right the contents of ... */
+    0x81  /* ... this zero page location */
+};
+
+/******************************************************************************
+ * BRK and RTI
+ *****************************************************************************/
+
+const uint8_t test_cart_BRK_Implied[2] = {
+    0x00, /* BRK, jump through the interrupt vector ... */
+    0xEA  /* ... skipping this padding byte on return */
+};
+
+const uint8_t test_cart_RTI_Implied[1] = {
+    0x40  /* RTI, restore the status register and program counter */
+};
+
+/******************************************************************************
+ * BVS
+ *****************************************************************************/
+
+const uint8_t test_cart_BVS_Relative_Boundary_Cross[2] = {
+    0x70, /* BVS, branch if overflow is set ... */
+    0x80  /* ... back 128 bytes, into the previous page */
+};
+
 #endif /* EXEC_TESTS */
 
@@ -79,6 +79,41 @@ extern const uint8_t test_cart_STY_Zero_Page[4];
 extern const uint8_t test_cart_STY_Zero_Page_X_Indexed[4];
 extern const uint8_t test_cart_STY_Absolute[5];
 
+/******************************************************************************
+ * ADC
+ *****************************************************************************/
+
+extern const uint8_t test_cart_ADC_Immediate[4];
+extern const uint8_t test_cart_ADC_Decimal[7];
+
+/******************************************************************************
+ * SBC
+ *****************************************************************************/
+
+extern const uint8_t test_cart_SBC_Decimal[7];
+
+/******************************************************************************
+ * Shifts and rotates
+ *****************************************************************************/
+
+extern const uint8_t test_cart_ASL_Zero_Page[2];
+extern const uint8_t test_cart_LSR_Zero_Page[2];
+extern const uint8_t test_cart_ROL_Zero_Page[2];
+extern const uint8_t test_cart_ROR_Zero_Page[2];
+
+/******************************************************************************
+ * BRK and RTI
+ *****************************************************************************/
+
+extern const uint8_t test_cart_BRK_Implied[2];
+extern const uint8_t test_cart_RTI_Implied[1];
+
+/******************************************************************************
+ * BVS
+ *****************************************************************************/
+
+extern const uint8_t test_cart_BVS_Relative_Boundary_Cross[2];
+
 #endif /* EXEC_TESTS */
 
 #endif /* _TEST_CARTS_H */
@@ -19,10 +19,35 @@
 #include "debug.h"
 #include "test-carts.h"
 
-#define RESET() \
+/* Test programs are only a few bytes long, so each is copied to the start
+ * of a full size cartridge image whose reset vector points at it. The
+ * cartridge has to be in place before the CPU is reset so the vector can
+ * be read.
+ */
+#define TEST_CART_SIZE (MEMMAP_CART_END - MEMMAP_CART_START + 1)
+
+static uint8_t test_cart[TEST_CART_SIZE];
+
+#define RESET(program) \
     mos6532_clear_memory(); \
+    load_test_cart(program, sizeof(program)); \
     mos6507_reset(); \
 
+static void load_test_cart(const uint8_t *program, int length)
+{
+    int i;
+
+    for (i=0; i<TEST_CART_SIZE; i++) {
+        test_cart[i] = (i < length) ? program[i] : 0xEA; /* NOP */
+    }
+    /* Reset at the start of the program, BRK to 0xF080 */
+    test_cart[0xFFC] = 0x00;
+    test_cart[0xFFD] = 0xF0;
+    test_cart[0xFFE] = 0x80;
+    test_cart[0xFFF] = 0xF0;
+    cartridge_load(test_cart);
+}
+
 void execute_tests(void)
 {
     puts("============ Executing unit tests ============");
@@ -33,6 +58,11 @@ void execute_tests(void)
     test_STA();
     test_STX();
     test_STY();
+    test_ADC();
+    test_SBC();
+    test_Shift();
+    test_Interrupt();
+    test_BVS();
 
     puts("====== All tests completed successfully ======");
 }
@@ -98,11 +128,10 @@ void test_LDA(void)
 void test_LDA_Immediate(void)
 {
     puts("+ Testing LDA [ 0xA9 ], immediate addressing mode");
-    RESET()
+    RESET(test_cart_LDA_Immediate)
     uint8_t data = 0;
 
     /* Perform test */
-    cartridge_load(test_cart_LDA_Immediate);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the immediate operand */
     /* End test */
@@ -114,14 +143,13 @@ void test_LDA_Immediate(void)
 void test_LDA_Zero_Page(void)
 {
     puts("+ Testing LDA [ 0xA5 ], zero page addressing mode");
-    RESET()
+    RESET(test_cart_LDA_Zero_Page)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
     insert_test_data(0x0081, 0xAA);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDA_Zero_Page);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
     mos6507_clock_tick(); /* Fetch the value from memory and load it */
@@ -135,7 +163,7 @@ void test_LDA_Zero_Page(void)
 void test_LDA_Zero_Page_X_Indexed(void)
 {
     puts("+ Testing LDA [ 0xB5 ], zero page X indexed addressing mode");
-    RESET()
+    RESET(test_cart_LDA_Zero_Page_X_Indexed)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
@@ -145,7 +173,6 @@ void test_LDA_Zero_Page_X_Indexed(void)
     mos6507_set_register(MOS6507_REG_X, 0x01);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDA_Zero_Page_X_Indexed);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
     mos6507_clock_tick(); /* Fetch the value from memory and use it as the next address */
@@ -160,14 +187,13 @@ void test_LDA_Zero_Page_X_Indexed(void)
 void test_LDA_Absolute(void)
 {
     puts("+ Testing LDA [ 0xAD ], absolute addressing mode");
-    RESET()
+    RESET(test_cart_LDA_Absolute)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x2001, 0xAA);
+    insert_test_data(0x0181, 0xAA);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDA_Absolute);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the low memory location */
     mos6507_clock_tick(); /* Fetch the next byte for the high memory location */
@@ -182,17 +208,16 @@ void test_LDA_Absolute(void)
 void test_LDA_Absolute_X_Indexed(void)
 {
     puts("+ Testing LDA [ 0xBD ], absolute X indexed addressing mode");
-    RESET()
+    RESET(test_cart_LDA_Absolute_X_Indexed)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x2001, 0xAA);
+    insert_test_data(0x0181, 0xAA);
 
-    /* The cartridge specifies 0x2000, this offset gets us to the correct location */
+    /* The cartridge specifies 0x0180, this offset gets us to the correct location */
     mos6507_set_register(MOS6507_REG_X, 0x01);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDA_Absolute_X_Indexed);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the low memory location */
     mos6507_clock_tick(); /* Fetch the next byte for the high memory location */
@@ -207,17 +232,16 @@ void test_LDA_Absolute_X_Indexed(void)
 void test_LDA_Absolute_X_Indexed_Boundary_Cross(void)
 {
     puts("+ Testing LDA [ 0xAD ], absolute X indexed addressing mode with boundary crossing");
-    RESET()
+    RESET(test_cart_LDA_Absolute_X_Indexed_Boundary_Cross)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x0100, 0xAA);
+    insert_test_data(0x0181, 0xAA);
 
-    /* The cartridge specifies 0x2000, this offset gets us to the correct location */
-    mos6507_set_register(MOS6507_REG_X, 0x01);
+    /* The cartridge specifies 0x00FF, this offset carries into the RAM mirror at 0x0181 */
+    mos6507_set_register(MOS6507_REG_X, 0x82);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDA_Absolute_X_Indexed_Boundary_Cross);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the low memory location */
     mos6507_clock_tick(); /* Fetch the next byte for the high memory location */
@@ -233,17 +257,16 @@ void test_LDA_Absolute_X_Indexed_Boundary_Cross(void)
 void test_LDA_Absolute_Y_Indexed(void)
 {
     puts("+ Testing LDA [ 0xA9 ], absolute Y indexed addressing mode");
-    RESET()
+    RESET(test_cart_LDA_Absolute_Y_Indexed)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x2001, 0xAA);
+    insert_test_data(0x0181, 0xAA);
 
-    /* The cartridge specifies 0x2000, this offset gets us to the correct location */
+    /* The cartridge specifies 0x0180, this offset gets us to the correct location */
     mos6507_set_register(MOS6507_REG_Y, 0x01);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDA_Absolute_Y_Indexed);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the low memory location */
     mos6507_clock_tick(); /* Fetch the next byte for the high memory location */
@@ -258,17 +281,16 @@ void test_LDA_Absolute_Y_Indexed(void)
 void test_LDA_Absolute_Y_Indexed_Boundary_Cross(void)
 {
     puts("+ Testing LDA [ 0xA9 ], absolute Y indexed addressing mode with boundary crossing");
-    RESET()
+    RESET(test_cart_LDA_Absolute_Y_Indexed_Boundary_Cross)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x0100, 0xAA);
+    insert_test_data(0x0181, 0xAA);
 
-    /* The cartridge specifies 0x2000, this offset gets us to the correct location */
-    mos6507_set_register(MOS6507_REG_Y, 0x01);
+    /* The cartridge specifies 0x00FF, this offset carries into the RAM mirror at 0x0181 */
+    mos6507_set_register(MOS6507_REG_Y, 0x82);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDA_Absolute_Y_Indexed_Boundary_Cross);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the low memory location */
     mos6507_clock_tick(); /* Fetch the next byte for the high memory location */
@@ -284,7 +306,7 @@ void test_LDA_Absolute_Y_Indexed_Boundary_Cross(void)
 void test_LDA_Indirect_X_Indexed(void)
 {
     puts("+ Testing LDA [ 0xA1 ], indirect X indexed addressing mode");
-    RESET()
+    RESET(test_cart_LDA_Indirect_X_Indexed)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
@@ -295,7 +317,6 @@ void test_LDA_Indirect_X_Indexed(void)
     mos6507_set_register(MOS6507_REG_X, 0x01);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDA_Indirect_X_Indexed);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the zero page base address */
     mos6507_clock_tick(); /* Set the data bus */
@@ -312,7 +333,7 @@ void test_LDA_Indirect_X_Indexed(void)
 void test_LDA_Indirect_Y_Indexed(void)
 {
     puts("+ Testing LDA [ 0xB1 ], indirect Y indexed addressing mode");
-    RESET()
+    RESET(test_cart_LDA_Indirect_Y_Indexed)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
@@ -324,7 +345,6 @@ void test_LDA_Indirect_Y_Indexed(void)
     mos6507_set_register(MOS6507_REG_Y, 0x02);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDA_Indirect_Y_Indexed);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the address offset */
     mos6507_clock_tick(); /* Apply the offset and read the low byte */
@@ -359,11 +379,10 @@ void test_LDX(void)
 void test_LDX_Immediate(void)
 {
     puts("+ Testing LDX [ 0xA2 ], immediate addressing mode");
-    RESET()
+    RESET(test_cart_LDX_Immediate)
     uint8_t data = 0;
 
     /* Perform test */
-    cartridge_load(test_cart_LDX_Immediate);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the immediate operand */
     /* End test */
@@ -376,14 +395,13 @@ void test_LDX_Immediate(void)
 void test_LDX_Zero_Page(void)
 {
     puts("+ Testing LDX [ 0xA6 ], zero page addressing mode");
-    RESET()
+    RESET(test_cart_LDX_Zero_Page)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
     insert_test_data(0x0081, 0xAA);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDX_Zero_Page);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
     mos6507_clock_tick(); /* Fetch the value from memory and load it */
@@ -398,7 +416,7 @@ void test_LDX_Zero_Page(void)
 void test_LDX_Zero_Page_Y_Indexed(void)
 {
     puts("+ Testing LDX [ 0xB6 ], zero page Y indexed addressing mode");
-    RESET()
+    RESET(test_cart_LDX_Zero_Page_Y_Indexed)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
@@ -408,7 +426,6 @@ void test_LDX_Zero_Page_Y_Indexed(void)
     mos6507_set_register(MOS6507_REG_Y, 0x01);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDX_Zero_Page_Y_Indexed);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
     mos6507_clock_tick(); /* Fetch the value from memory and use it as the next address */
@@ -423,14 +440,13 @@ void test_LDX_Zero_Page_Y_Indexed(void)
 void test_LDX_Absolute(void)
 {
     puts("+ Testing LDX [ 0xAE ], absolute addressing mode");
-    RESET()
+    RESET(test_cart_LDX_Absolute)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x2001, 0xAA);
+    insert_test_data(0x0181, 0xAA);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDX_Absolute);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the low memory location */
     mos6507_clock_tick(); /* Fetch the next byte for the high memory location */
@@ -445,17 +461,16 @@ void test_LDX_Absolute(void)
 void test_LDX_Absolute_Y_Indexed(void)
 {
     puts("+ Testing LDX [ 0xBE ], absolute Y indexed addressing mode");
-    RESET()
+    RESET(test_cart_LDX_Absolute_Y_Indexed)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x2001, 0xAA);
+    insert_test_data(0x0181, 0xAA);
 
-    /* The cartridge specifies 0x2000, this offset gets us to the correct location */
+    /* The cartridge specifies 0x0180, this offset gets us to the correct location */
     mos6507_set_register(MOS6507_REG_Y, 0x01);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDX_Absolute_Y_Indexed);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the low memory location */
     mos6507_clock_tick(); /* Fetch the next byte for the high memory location */
@@ -470,17 +485,16 @@ void test_LDX_Absolute_Y_Indexed(void)
 void test_LDX_Absolute_Y_Indexed_Boundary_Cross(void)
 {
     puts("+ Testing LDX [ 0xBE ], absolute Y indexed addressing mode with boundary crossing");
-    RESET()
+    RESET(test_cart_LDX_Absolute_Y_Indexed_Boundary_Cross)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x0100, 0xAA);
+    insert_test_data(0x0181, 0xAA);
 
-    /* The cartridge specifies 0x2000, this offset gets us to the correct location */
-    mos6507_set_register(MOS6507_REG_Y, 0x01);
+    /* The cartridge specifies 0x00FF, this offset carries into the RAM mirror at 0x0181 */
+    mos6507_set_register(MOS6507_REG_Y, 0x82);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDX_Absolute_Y_Indexed_Boundary_Cross);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the low memory location */
     mos6507_clock_tick(); /* Fetch the next byte for the high memory location */
@@ -514,11 +528,10 @@ void test_LDY(void)
 void test_LDY_Immediate(void)
 {
     puts("+ Testing LDY [ 0xA0 ], immediate addressing mode");
-    RESET()
+    RESET(test_cart_LDY_Immediate)
     uint8_t data = 0;
 
     /* Perform test */
-    cartridge_load(test_cart_LDY_Immediate);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the immediate operand */
     /* End test */
@@ -531,14 +544,13 @@ void test_LDY_Immediate(void)
 void test_LDY_Zero_Page(void)
 {
     puts("+ Testing LDY [ 0xA4 ], zero page addressing mode");
-    RESET()
+    RESET(test_cart_LDY_Zero_Page)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
     insert_test_data(0x0081, 0xAA);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDY_Zero_Page);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
     mos6507_clock_tick(); /* Fetch the value from memory and load it */
@@ -553,7 +565,7 @@ void test_LDY_Zero_Page(void)
 void test_LDY_Zero_Page_X_Indexed(void)
 {
     puts("+ Testing LDY [ 0xB4 ], zero page X indexed addressing mode");
-    RESET()
+    RESET(test_cart_LDY_Zero_Page_X_Indexed)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
@@ -563,7 +575,6 @@ void test_LDY_Zero_Page_X_Indexed(void)
     mos6507_set_register(MOS6507_REG_X, 0x01);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDY_Zero_Page_X_Indexed);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
     mos6507_clock_tick(); /* Fetch the value from memory and use it as the next address */
@@ -578,14 +589,13 @@ void test_LDY_Zero_Page_X_Indexed(void)
 void test_LDY_Absolute(void)
 {
     puts("+ Testing LDY [ 0xAC ], absolute addressing mode");
-    RESET()
+    RESET(test_cart_LDY_Absolute)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x2001, 0xAA);
+    insert_test_data(0x0181, 0xAA);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDY_Absolute);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the low memory location */
     mos6507_clock_tick(); /* Fetch the next byte for the high memory location */
@@ -600,17 +610,16 @@ void test_LDY_Absolute(void)
 void test_LDY_Absolute_X_Indexed(void)
 {
     puts("+ Testing LDX [ 0xBC ], absolute X indexed addressing mode");
-    RESET()
+    RESET(test_cart_LDY_Absolute_X_Indexed)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x2001, 0xAA);
+    insert_test_data(0x0181, 0xAA);
 
-    /* The cartridge specifies 0x2000, this offset gets us to the correct location */
+    /* The cartridge specifies 0x0180, this offset gets us to the correct location */
     mos6507_set_register(MOS6507_REG_X, 0x01);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDY_Absolute_X_Indexed);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the low memory location */
     mos6507_clock_tick(); /* Fetch the next byte for the high memory location */
@@ -625,17 +634,16 @@ void test_LDY_Absolute_X_Indexed(void)
 void test_LDY_Absolute_X_Indexed_Boundary_Cross(void)
 {
     puts("+ Testing LDY [ 0xBC ], absolute X indexed addressing mode with boundary crossing");
-    RESET()
+    RESET(test_cart_LDY_Absolute_X_Indexed_Boundary_Cross)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x0100, 0xAA);
+    insert_test_data(0x0181, 0xAA);
 
-    /* The cartridge specifies 0x2000, this offset gets us to the correct location */
-    mos6507_set_register(MOS6507_REG_X, 0x01);
+    /* The cartridge specifies 0x00FF, this offset carries into the RAM mirror at 0x0181 */
+    mos6507_set_register(MOS6507_REG_X, 0x82);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_LDY_Absolute_X_Indexed_Boundary_Cross);
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the low memory location */
     mos6507_clock_tick(); /* Fetch the next byte for the high memory location */
@@ -670,11 +678,10 @@ void test_STA(void)
 void test_STA_Zero_Page(void)
 {
     puts("+ Testing STA [ 0xA9 ], zero page addressing mode");
-    RESET()
+    RESET(test_cart_STA_Zero_Page)
     uint8_t data = 0;
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STA_Zero_Page);
     /* Load (LDA) a value into the Accumulator */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -693,14 +700,13 @@ void test_STA_Zero_Page(void)
 void test_STA_Zero_Page_X_Indexed(void)
 {
     puts("+ Testing STA [ 0x95 ], zero page X indexed addressing mode");
-    RESET()
+    RESET(test_cart_STA_Zero_Page_X_Indexed)
     uint8_t data = 0;
 
     /* Set out offset to be added to the address in the cartridge */
     mos6507_set_register(MOS6507_REG_X, 0x09);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STA_Zero_Page_X_Indexed);
     /* Load (LDA) a value into the Accumulator */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -720,11 +726,10 @@ void test_STA_Zero_Page_X_Indexed(void)
 void test_STA_Absolute(void)
 {
     puts("+ Testing STA [ 0x8D ], absolute addressing mode");
-    RESET()
+    RESET(test_cart_STA_Absolute)
     uint8_t data = 0;
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STA_Absolute);
     /* Load (LDA) a value into the Accumulator */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -744,14 +749,13 @@ void test_STA_Absolute(void)
 void test_STA_Absolute_X_Indexed(void)
 {
     puts("+ Testing STA [ 0x9D ], absolute X indexed addressing mode");
-    RESET()
+    RESET(test_cart_STA_Absolute_X_Indexed)
     uint8_t data = 0;
 
     /* Set out offset to be added to the address in the cartridge */
     mos6507_set_register(MOS6507_REG_X, 0x0F);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STA_Absolute_X_Indexed);
     /* Load (LDA) a value into the Accumulator */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -772,14 +776,13 @@ void test_STA_Absolute_X_Indexed(void)
 void test_STA_Absolute_Y_Indexed(void)
 {
     puts("+ Testing STA [ 0x99 ], absolute Y indexed addressing mode");
-    RESET()
+    RESET(test_cart_STA_Absolute_Y_Indexed)
     uint8_t data = 0;
 
     /* Set out offset to be added to the address in the cartridge */
     mos6507_set_register(MOS6507_REG_Y, 0x0F);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STA_Absolute_Y_Indexed);
     /* Load (LDA) a value into the Accumulator */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -800,7 +803,7 @@ void test_STA_Absolute_Y_Indexed(void)
 void test_STA_Indirect_X_Indexed(void)
 {
     puts("+ Testing STA [ 0x81 ], indirect X indexed addressing mode");
-    RESET()
+    RESET(test_cart_STA_Indirect_X_Indexed)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
@@ -812,7 +815,6 @@ void test_STA_Indirect_X_Indexed(void)
     mos6507_set_register(MOS6507_REG_X, 0x05);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STA_Indirect_X_Indexed);
     /* Load (LDA) a value into the Accumulator */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -834,19 +836,17 @@ void test_STA_Indirect_X_Indexed(void)
 void test_STA_Indirect_Y_Indexed(void)
 {
     puts("+ Testing STA [ 0x91 ], indirect Y indexed addressing mode");
-    RESET()
+    RESET(test_cart_STA_Indirect_Y_Indexed)
     uint8_t data = 0;
 
     /* Setup the test by pre-loading our test data into memory */
-    insert_test_data(0x0090, 0x90);
-    insert_test_data(0x0095, 0xFF);
+    insert_test_data(0x0095, 0xFA);
     insert_test_data(0x0096, 0x01);
 
     /* Set out offset to be added to the address in the cartridge */
     mos6507_set_register(MOS6507_REG_Y, 0x05);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STA_Indirect_Y_Indexed);
     /* Load (LDA) a value into the Accumulator */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -883,11 +883,10 @@ void test_STX(void)
 void test_STX_Zero_Page(void)
 {
     puts("+ Testing STX [ 0x86 ], zero page addressing mode");
-    RESET()
+    RESET(test_cart_STX_Zero_Page)
     uint8_t data = 0;
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STX_Zero_Page);
     /* Load (LDX) a value into the X index register */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -906,14 +905,13 @@ void test_STX_Zero_Page(void)
 void test_STX_Zero_Page_Y_Indexed(void)
 {
     puts("+ Testing STX [ 0x96 ], zero page Y indexed addressing mode");
-    RESET()
+    RESET(test_cart_STX_Zero_Page_Y_Indexed)
     uint8_t data = 0;
 
     /* Set out offset to be added to the address in the cartridge */
     mos6507_set_register(MOS6507_REG_Y, 0x09);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STX_Zero_Page_Y_Indexed);
     /* Load (LDX) a value into the X index register */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -933,11 +931,10 @@ void test_STX_Zero_Page_Y_Indexed(void)
 void test_STX_Absolute(void)
 {
     puts("+ Testing STX [ 0x8E ], absolute addressing mode");
-    RESET()
+    RESET(test_cart_STX_Absolute)
     uint8_t data = 0;
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STX_Absolute);
     /* Load (LDX) a value into the X index register */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -972,11 +969,10 @@ void test_STY(void)
 void test_STY_Zero_Page(void)
 {
     puts("+ Testing STY [ 0x84 ], zero page addressing mode");
-    RESET()
+    RESET(test_cart_STY_Zero_Page)
     uint8_t data = 0;
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STY_Zero_Page);
     /* Load (LDY) a value into the Y index register */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -995,14 +991,13 @@ void test_STY_Zero_Page(void)
 void test_STY_Zero_Page_X_Indexed(void)
 {
     puts("+ Testing STY [ 0x94 ], zero page X indexed addressing mode");
-    RESET()
+    RESET(test_cart_STY_Zero_Page_X_Indexed)
     uint8_t data = 0;
 
     /* Set out offset to be added to the address in the cartridge */
     mos6507_set_register(MOS6507_REG_X, 0x09);
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STY_Zero_Page_X_Indexed);
     /* Load (LDY) a value into the Y index register */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -1022,11 +1017,10 @@ void test_STY_Zero_Page_X_Indexed(void)
 void test_STY_Absolute(void)
 {
     puts("+ Testing STY [ 0x8C ], absolute addressing mode");
-    RESET()
+    RESET(test_cart_STY_Absolute)
     uint8_t data = 0;
 
     /* Now load our test program and start clocking the CPU */
-    cartridge_load(test_cart_STY_Absolute);
     /* Load (LDY) a value into the Y index register */
     mos6507_clock_tick(); /* Read the instruction */
     mos6507_clock_tick(); /* Fetch the next byte for the memory location */
@@ -1052,6 +1046,7 @@ void test_ADC(void)
     puts("--- Testing ADC:");
 
     test_ADC_Immediate();
+    test_ADC_Decimal();
 
     puts("--- All ADC tests completed successfully.");
 
@@ -1060,16 +1055,311 @@ void test_ADC(void)
 void test_ADC_Immediate(void)
 {
     puts("+ Testing ADC [ 0x69 ], immediate addressing mode");
-    RESET()
-    uint8_t accumulator, P = 0;
+    RESET(test_cart_ADC_Immediate)
+    uint8_t accumulator = 0;
+
+    /* Load (LDA) a value into the Accumulator */
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Fetch the next byte for the immediate operand */
+    /* Now execute the addition (ADC) */
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Fetch the next byte and add it */
+    /* End test */
 
     /* Do we have the expected result in the Accumulator and 
      * has the Carry bit been set correctly? */
-    mos6507_get_register(MOS6507_REG_S, &P);
-    assert(MOS6507_STATUS_FLAG_CARRY & P);
+    assert(mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY));
+
+    mos6507_get_register(MOS6507_REG_A, &accumulator);
+    assert(accumulator == 10);
+}
+
+void test_ADC_Decimal(void)
+{
+    puts("+ Testing ADC [ 0x69 ], immediate addressing mode in decimal mode");
+    RESET(test_cart_ADC_Decimal)
+    uint8_t accumulator = 0;
+
+    mos6507_clock_tick(); /* Read the instruction (SED) */
+    mos6507_clock_tick(); /* Set the decimal flag */
+    mos6507_clock_tick(); /* Read the instruction (CLC) */
+    mos6507_clock_tick(); /* Clear the carry flag */
+    /* Load (LDA) a value into the Accumulator */
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Fetch the next byte for the immediate operand */
+    /* Now execute the addition (ADC) */
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Fetch the next byte and add it */
+    /* End test */
+
+    /* Has 99 + 1 wrapped round to 00 in BCD, carrying into the next digit? */
+    mos6507_get_register(MOS6507_REG_A, &accumulator);
+    assert(accumulator == 0x00);
+    assert(mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY));
+
+    /* As on the NMOS 6502, zero follows the binary sum (0x9A) while
+     * negative and overflow follow the sum after the low digit is
+     * adjusted (0xA0) */
+    assert(!mos6507_get_status_flag(MOS6507_STATUS_FLAG_ZERO));
+    assert(mos6507_get_status_flag(MOS6507_STATUS_FLAG_NEGATIVE));
+    assert(!mos6507_get_status_flag(MOS6507_STATUS_FLAG_OVERFLOW));
+}
+
+/******************************************************************************
+ * Subtract from Accumulator with borrow
+ *****************************************************************************/
 
+void test_SBC(void)
+{
+    puts("--- Testing SBC:");
+
+    test_SBC_Decimal();
+
+    puts("--- All SBC tests completed successfully.");
+}
+
+void test_SBC_Decimal(void)
+{
+    puts("+ Testing SBC [ 0xE9 ], immediate addressing mode in decimal mode");
+    RESET(test_cart_SBC_Decimal)
+    uint8_t accumulator = 0;
+
+    mos6507_clock_tick(); /* Read the instruction (SED) */
+    mos6507_clock_tick(); /* Set the decimal flag */
+    mos6507_clock_tick(); /* Read the instruction (SEC) */
+    mos6507_clock_tick(); /* Set the carry flag */
+    /* Load (LDA) a value into the Accumulator */
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Fetch the next byte for the immediate operand */
+    /* Now execute the subtraction (SBC) */
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Fetch the next byte and subtract it */
+    /* End test */
+
+    /* Has 00 - 1 wrapped round to 99 in BCD, borrowing (clearing the
+     * carry) from the next digit? */
     mos6507_get_register(MOS6507_REG_A, &accumulator);
-    assert(accumulator = 10);
+    assert(accumulator == 0x99);
+    assert(!mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY));
+
+    /* As on the NMOS 6502, the other flags follow the binary
+     * subtraction (0xFF) */
+    assert(!mos6507_get_status_flag(MOS6507_STATUS_FLAG_ZERO));
+    assert(mos6507_get_status_flag(MOS6507_STATUS_FLAG_NEGATIVE));
+    assert(!mos6507_get_status_flag(MOS6507_STATUS_FLAG_OVERFLOW));
+}
+
+/******************************************************************************
+ * Shift and rotate memory
+ *****************************************************************************/
+
+void test_Shift(void)
+{
+    puts("--- Testing ASL, LSR, ROL and ROR:");
+
+    test_ASL_Zero_Page();
+    test_LSR_Zero_Page();
+    test_ROL_Zero_Page();
+    test_ROR_Zero_Page();
+
+    puts("--- All shift and rotate tests completed successfully.");
+}
+
+void test_ASL_Zero_Page(void)
+{
+    puts("+ Testing ASL [ 0x06 ], zero page addressing mode");
+    RESET(test_cart_ASL_Zero_Page)
+    uint8_t data = 0;
+
+    /* Setup the test by pre-loading our test data into memory */
+    insert_test_data(0x0081, 0x41);
+
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Fetch the zero page address */
+    mos6507_clock_tick(); /* Read the value from memory */
+    mos6507_clock_tick(); /* Write the unmodified value back */
+    mos6507_clock_tick(); /* Write the shifted value back */
+    /* End test */
+
+    /* Has the shifted result (0x82) been written back to memory? */
+    read_test_data(0x0081, &data);
+    assert(data == 0x82);
+    assert(!mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY));
+}
+
+void test_LSR_Zero_Page(void)
+{
+    puts("+ Testing LSR [ 0x46 ], zero page addressing mode");
+    RESET(test_cart_LSR_Zero_Page)
+    uint8_t data = 0;
+
+    /* Setup the test by pre-loading our test data into memory */
+    insert_test_data(0x0081, 0x03);
+
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Fetch the zero page address */
+    mos6507_clock_tick(); /* Read the value from memory */
+    mos6507_clock_tick(); /* Write the unmodified value back */
+    mos6507_clock_tick(); /* Write the shifted value back */
+    /* End test */
+
+    /* Has the shifted result (0x01) been written back to memory, with bit 0
+     * moved into the Carry? */
+    read_test_data(0x0081, &data);
+    assert(data == 0x01);
+    assert(mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY));
+}
+
+void test_ROL_Zero_Page(void)
+{
+    puts("+ Testing ROL [ 0x26 ], zero page addressing mode");
+    RESET(test_cart_ROL_Zero_Page)
+    uint8_t data = 0;
+
+    /* Setup the test by pre-loading our test data into memory */
+    insert_test_data(0x0081, 0x80);
+    mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, 1);
+
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Fetch the zero page address */
+    mos6507_clock_tick(); /* Read the value from memory */
+    mos6507_clock_tick(); /* Write the unmodified value back */
+    mos6507_clock_tick(); /* Write the rotated value back */
+    /* End test */
+
+    /* Has the rotated result (0x01) been written back to memory, with bit 7
+     * moved into the Carry? */
+    read_test_data(0x0081, &data);
+    assert(data == 0x01);
+    assert(mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY));
+}
+
+void test_ROR_Zero_Page(void)
+{
+    puts("+ Testing ROR [ 0x66 ], zero page addressing mode");
+    RESET(test_cart_ROR_Zero_Page)
+    uint8_t data = 0;
+
+    /* Setup the test by pre-loading our test data into memory */
+    insert_test_data(0x0081, 0x02);
+    mos6507_set_status_flag(MOS6507_STATUS_FLAG_CARRY, 1);
+
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Fetch the zero page address */
+    mos6507_clock_tick(); /* Read the value from memory */
+    mos6507_clock_tick(); /* Write the unmodified value back */
+    mos6507_clock_tick(); /* Write the rotated value back */
+    /* End test */
+
+    /* Has the rotated result (0x81) been written back to memory, with bit 0
+     * moved into the Carry? */
+    read_test_data(0x0081, &data);
+    assert(data == 0x81);
+    assert(!mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY));
+}
+
+/******************************************************************************
+ * Break and return from interrupt
+ *****************************************************************************/
+
+void test_Interrupt(void)
+{
+    puts("--- Testing BRK and RTI:");
+
+    test_BRK_Implied();
+    test_RTI_Implied();
+
+    puts("--- All BRK and RTI tests completed successfully.");
+}
+
+void test_BRK_Implied(void)
+{
+    puts("+ Testing BRK [ 0x00 ], implied addressing mode");
+    RESET(test_cart_BRK_Implied)
+    uint8_t data = 0;
+
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Skip the padding byte */
+    mos6507_clock_tick(); /* Push the high byte of the return address */
+    mos6507_clock_tick(); /* Push the low byte of the return address */
+    mos6507_clock_tick(); /* Push the status register */
+    mos6507_clock_tick(); /* Fetch the low byte of the vector */
+    mos6507_clock_tick(); /* Fetch the high byte of the vector and jump */
+    /* End test */
+
+    /* Have we jumped through the vector, with the address following the
+     * padding byte and the status register on the stack? */
+    assert(mos6507_get_PC() == 0xF080);
+    read_test_data(0x01FF, &data);
+    assert(data == 0xF0);
+    read_test_data(0x01FE, &data);
+    assert(data == 0x02);
+    read_test_data(0x01FD, &data);
+    assert(data & MOS6507_STATUS_FLAG_BREAK);
+    assert(mos6507_get_status_flag(MOS6507_STATUS_FLAG_INTERRUPT));
+    mos6507_get_register(MOS6507_REG_S, &data);
+    assert(data == 0xFC);
+}
+
+void test_RTI_Implied(void)
+{
+    puts("+ Testing RTI [ 0x40 ], implied addressing mode");
+    RESET(test_cart_RTI_Implied)
+    uint8_t data = 0;
+
+    /* Setup the stack as an interrupt would have left it */
+    insert_test_data(0x01FD, 0xC3);
+    insert_test_data(0x01FE, 0x40);
+    insert_test_data(0x01FF, 0xF0);
+    mos6507_set_register(MOS6507_REG_S, 0xFC);
+
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Read the next byte, discarded */
+    mos6507_clock_tick(); /* Increment the stack pointer */
+    mos6507_clock_tick(); /* Pull the status register */
+    mos6507_clock_tick(); /* Pull the low byte of the return address */
+    mos6507_clock_tick(); /* Pull the high byte of the return address */
+    /* End test */
+
+    /* Have the status register (N, V, Z and C set) and return address been
+     * restored, leaving the stack pointer alone? */
+    assert(mos6507_get_PC() == 0xF040);
+    assert(mos6507_get_status_flag(MOS6507_STATUS_FLAG_NEGATIVE));
+    assert(mos6507_get_status_flag(MOS6507_STATUS_FLAG_OVERFLOW));
+    assert(mos6507_get_status_flag(MOS6507_STATUS_FLAG_ZERO));
+    assert(mos6507_get_status_flag(MOS6507_STATUS_FLAG_CARRY));
+    mos6507_get_register(MOS6507_REG_S, &data);
+    assert(data == 0xFF);
+}
+
+/******************************************************************************
+ * Branch on overflow set
+ *****************************************************************************/
+
+void test_BVS(void)
+{
+    puts("--- Testing BVS:");
+
+    test_BVS_Relative_Boundary_Cross();
+
+    puts("--- All BVS tests completed successfully.");
+}
+
+void test_BVS_Relative_Boundary_Cross(void)
+{
+    puts("+ Testing BVS [ 0x70 ], relative addressing mode with boundary crossing");
+    RESET(test_cart_BVS_Relative_Boundary_Cross)
+
+    mos6507_set_status_flag(MOS6507_STATUS_FLAG_OVERFLOW, 1);
+
+    mos6507_clock_tick(); /* Read the instruction */
+    mos6507_clock_tick(); /* Fetch the offset */
+    mos6507_clock_tick(); /* Add the offset to the low byte of the PC */
+    mos6507_clock_tick(); /* Fix up the high byte of the PC */
+    /* End test */
+
+    /* Has the branch landed on 0xF002 - 128 exactly? */
+    assert(mos6507_get_PC() == 0xEF82);
 }
 
 #endif /* EXEC_TESTS */
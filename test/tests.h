@@ -62,6 +62,23 @@ void test_STY_Absolute(void);
 
 void test_ADC(void);
 void test_ADC_Immediate(void);
+void test_ADC_Decimal(void);
+
+void test_SBC(void);
+void test_SBC_Decimal(void);
+
+void test_Shift(void);
+void test_ASL_Zero_Page(void);
+void test_LSR_Zero_Page(void);
+void test_ROL_Zero_Page(void);
+void test_ROR_Zero_Page(void);
+
+void test_Interrupt(void);
+void test_BRK_Implied(void);
+void test_RTI_Implied(void);
+
+void test_BVS(void);
+void test_BVS_Relative_Boundary_Cross(void);
 
 #endif /* EXEC_TESTS */
 